@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include "game/ai_opponent.h"
+#include "reachable_positions.h"
+#include <vector>
+
+namespace tictactoe {
+namespace bench {
+
+// A best move for every reachable unfinished 3x3 position, through the
+// board interface the desktop client uses. These are answered from the 3x3
+// solution table; BM_Solve4x4 measures the search itself.
+void BM_ClassicBestMoveAllPositions(benchmark::State& state)
+{
+    std::vector<ClassicGameEngine> positions;
+    for (const ClassicGameEngine& position : reachablePositions()) {
+        if (!position.isGameOver()) {
+            positions.push_back(position);
+        }
+    }
+    std::vector<ClassicGameEngine::Board> boards;
+    for (const ClassicGameEngine& position : positions) {
+        boards.push_back(position.getBoard());
+    }
+
+    AIOpponent ai;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < boards.size(); ++i) {
+            benchmark::DoNotOptimize(ai.calculateBestMove(boards[i], positions[i].getCurrentPlayer()));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * boards.size()));
+}
+BENCHMARK(BM_ClassicBestMoveAllPositions)->Unit(benchmark::kMicrosecond);
+
+// Static evaluation of every reachable 3x3 board
+void BM_EvaluateBoard(benchmark::State& state)
+{
+    std::vector<ClassicGameEngine::Board> boards;
+    for (const ClassicGameEngine& position : reachablePositions()) {
+        boards.push_back(position.getBoard());
+    }
+
+    AIOpponent ai;
+    for (auto _ : state) {
+        for (const ClassicGameEngine::Board& board : boards) {
+            benchmark::DoNotOptimize(ai.evaluateBoard(board, Player::X));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * boards.size()));
+}
+BENCHMARK(BM_EvaluateBoard);
+
+// Exact solve of a 4x4 middle game from a cold table
+void BM_Solve4x4(benchmark::State& state)
+{
+    GameEngine4x4 engine;
+    for (const int cell : {5, 0, 10, 15}) {
+        engine.makeMove(cell);
+    }
+
+    BasicAIOpponent<GameEngine4x4> ai;
+    std::uint64_t nodes = 0;
+    for (auto _ : state) {
+        ai.getTranspositionTable().clear();
+        benchmark::DoNotOptimize(ai.calculateBestMove(engine));
+        nodes += ai.getNodeCount();
+    }
+    state.counters["nodes"] = benchmark::Counter(static_cast<double>(nodes), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_Solve4x4)->Unit(benchmark::kMillisecond);
+
+} // namespace bench
+} // namespace tictactoe
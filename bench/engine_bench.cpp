@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+#include "game/basic_game_engine.h"
+#include "game/ultimate_game_engine.h"
+#include "reachable_positions.h"
+#include <random>
+#include <vector>
+
+namespace tictactoe {
+namespace bench {
+
+namespace {
+
+// Moves of one random game to its end, the same on every run
+template <typename Engine>
+std::vector<int> randomGame(std::uint64_t seed)
+{
+    std::mt19937_64 rng(seed);
+    Engine engine;
+    std::vector<int> moves;
+    while (!engine.isGameOver()) {
+        auto legal = engine.getLegalMoves();
+        for (std::uint64_t skip = rng() % cellCount(legal); skip > 0; --skip) {
+            popLowestCell(legal);
+        }
+        moves.push_back(lowestCell(legal));
+        engine.makeMove(moves.back());
+    }
+    return moves;
+}
+
+// Finished games below this position, or positions `depth` plies down
+// once depth reaches 0 first
+template <typename Engine>
+std::uint64_t countGames(Engine& engine, int depth)
+{
+    if (engine.isGameOver() || depth == 0) {
+        return 1;
+    }
+    std::uint64_t games = 0;
+    auto moves = engine.getLegalMoves();
+    while (!isEmptyMask(moves)) {
+        engine.makeMove(popLowestCell(moves));
+        games += countGames(engine, depth - 1);
+        engine.undoMove();
+    }
+    return games;
+}
+
+} // namespace
+
+// Play a whole game and take it back; each move updates the line counters
+// that detect a win, so this covers the win check too
+template <typename Engine>
+void BM_MakeUndoMove(benchmark::State& state)
+{
+    const std::vector<int> moves = randomGame<Engine>(7);
+    Engine engine;
+    for (auto _ : state) {
+        for (const int cell : moves) {
+            engine.makeMove(cell);
+        }
+        benchmark::DoNotOptimize(engine.getGameState());
+        for (std::size_t i = 0; i < moves.size(); ++i) {
+            engine.undoMove();
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * moves.size()));
+}
+BENCHMARK_TEMPLATE(BM_MakeUndoMove, ClassicGameEngine);
+BENCHMARK_TEMPLATE(BM_MakeUndoMove, GameEngine4x4);
+BENCHMARK_TEMPLATE(BM_MakeUndoMove, GameEngine5x5);
+BENCHMARK_TEMPLATE(BM_MakeUndoMove, GomokuEngine);
+BENCHMARK_TEMPLATE(BM_MakeUndoMove, QubicEngine);
+BENCHMARK_TEMPLATE(BM_MakeUndoMove, UltimateGameEngine);
+
+// Load a board and check it for a win from scratch, as the desktop client
+// does for a board it did not play itself
+void BM_SetBoard(benchmark::State& state)
+{
+    std::vector<ClassicGameEngine::Board> boards;
+    std::vector<Player> toMove;
+    for (const ClassicGameEngine& position : reachablePositions()) {
+        boards.push_back(position.getBoard());
+        toMove.push_back(position.getCurrentPlayer());
+    }
+
+    ClassicGameEngine engine;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < boards.size(); ++i) {
+            engine.setBoard(boards[i], toMove[i]);
+            benchmark::DoNotOptimize(engine.getGameState());
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * boards.size()));
+}
+BENCHMARK(BM_SetBoard);
+
+// Every 3x3 game to its end: 255168 of them
+void BM_CountGames(benchmark::State& state)
+{
+    ClassicGameEngine engine;
+    std::uint64_t games = 0;
+    for (auto _ : state) {
+        games = countGames(engine, -1);
+        benchmark::DoNotOptimize(games);
+    }
+    if (games != 255168) {
+        state.SkipWithError("wrong number of 3x3 games");
+    }
+    state.counters["games"] = static_cast<double>(games);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * games));
+}
+BENCHMARK(BM_CountGames)->Unit(benchmark::kMillisecond);
+
+// Positions a few plies into 4x4, where full games are too many to count
+void BM_CountPositions4x4(benchmark::State& state)
+{
+    const int depth = static_cast<int>(state.range(0));
+    GameEngine4x4 engine;
+    std::uint64_t positions = 0;
+    for (auto _ : state) {
+        positions = countGames(engine, depth);
+        benchmark::DoNotOptimize(positions);
+    }
+    state.counters["positions"] = static_cast<double>(positions);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * positions));
+}
+BENCHMARK(BM_CountPositions4x4)->Arg(4)->Arg(5)->Unit(benchmark::kMillisecond);
+
+// Ultimate Tic-Tac-Toe perft 5: 473256 positions, each node listing its
+// legal moves from the sub-board masks
+void BM_UltimatePerft(benchmark::State& state)
+{
+    UltimateGameEngine engine;
+    std::uint64_t positions = 0;
+    for (auto _ : state) {
+        positions = countGames(engine, 5);
+        benchmark::DoNotOptimize(positions);
+    }
+    if (positions != 473256) {
+        state.SkipWithError("wrong Ultimate perft count");
+    }
+    state.counters["positions"] = static_cast<double>(positions);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * positions));
+}
+BENCHMARK(BM_UltimatePerft)->Unit(benchmark::kMillisecond);
+
+} // namespace bench
+} // namespace tictactoe
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "game/basic_game_engine.h"
+#include <unordered_set>
+#include <vector>
+
+namespace tictactoe {
+namespace bench {
+
+// Every position reachable from the empty 3x3 board by legal play, finished
+// games included: 5478 in all
+inline std::vector<ClassicGameEngine> reachablePositions()
+{
+    std::vector<ClassicGameEngine> positions;
+    std::unordered_set<std::uint64_t> seen;
+    ClassicGameEngine engine;
+
+    auto visit = [&](auto&& self) -> void {
+        if (!seen.insert(engine.getPositionIndex()).second) {
+            return;
+        }
+        positions.push_back(engine);
+        auto moves = engine.getLegalMoves();
+        while (!engine.isGameOver() && !isEmptyMask(moves)) {
+            engine.makeMove(popLowestCell(moves));
+            self(self);
+            engine.undoMove();
+        }
+    };
+    visit(visit);
+    return positions;
+}
+
+} // namespace bench
+} // namespace tictactoe
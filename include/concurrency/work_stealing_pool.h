@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tictactoe {
+
+// Fixed-size thread pool where every worker owns a task deque. Workers
+// take their own newest task first and, when idle, steal the oldest task
+// from another worker, so uneven task costs still keep all cores busy.
+// Tasks must not throw.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // 0 threads means one per hardware thread
+    explicit WorkStealingPool(unsigned threadCount = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Queue a task. Called from a worker it goes to that worker's deque,
+    // otherwise queues are filled round-robin.
+    void submit(Task task);
+
+    // Block until every submitted task has finished
+    void wait();
+
+    unsigned getThreadCount() const;
+
+    // Index of the calling pool worker, or -1 on any other thread
+    static int currentWorkerIndex();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(unsigned index);
+    bool popLocal(unsigned index, Task& task);
+    bool steal(unsigned thief, Task& task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex stateMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable allDone_;
+    std::atomic<std::size_t> queued_;
+    std::atomic<std::size_t> pending_;
+    std::atomic<unsigned> nextQueue_;
+    bool stopping_;
+};
+
+} // namespace tictactoe
@@ -1,34 +1,236 @@
 #pragma once
 
-#include "gameengine.h"
+#include "basic_game_engine.h"
+#include "transposition_table.h"
+#include "concurrency/work_stealing_pool.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace tictactoe {
 
-class AIOpponent {
+// Budget for one call to calculateBestMove; zero means no limit. With no
+// limit at all the position is solved exactly. Otherwise the search deepens
+// one ply at a time and returns the best move of the deepest finished pass
+// (or of the unfinished one, once it has found something better).
+struct SearchLimits {
+    std::chrono::milliseconds moveTime{0};
+    std::uint64_t maxNodes = 0;
+    int maxDepth = 0;
+    // Polled while searching, from any thread; once it reads true the search
+    // returns its best move so far. Not a limit for isUnlimited().
+    const std::atomic<bool>* cancel = nullptr;
+
+    bool isUnlimited() const
+    {
+        return moveTime.count() == 0 && maxNodes == 0 && maxDepth == 0;
+    }
+};
+
+// What one call to calculateBestMove did, summed over all search threads.
+// Counting is a few increments per node on counters each thread owns.
+struct SearchStats {
+    std::uint64_t nodes = 0;            // positions visited, root moves included
+    std::uint64_t expandedNodes = 0;    // positions whose moves were searched
+    std::uint64_t cutoffs = 0;          // beta cutoffs
+    std::uint64_t firstMoveCutoffs = 0; // cutoffs by the first move tried
+    std::uint64_t tableHits = 0;        // probes that found the position
+    std::uint64_t tableMisses = 0;
+    std::uint64_t tableCutoffs = 0;     // hits whose score ended the node
+    std::uint64_t proofNodes = 0;       // positions the proof solver visited
+    int completedDepth = 0;             // plies fully searched
+    int maxPly = 0;                     // deepest position searched
+    std::chrono::microseconds elapsed{0};
+
+    // Moves searched per expanded position; what alpha-beta leaves of the
+    // legal moves
+    double branchingFactor() const
+    {
+        return expandedNodes == 0 ? 0.0 : static_cast<double>(nodes) / static_cast<double>(expandedNodes);
+    }
+};
+
+template <typename Engine>
+class OutcomeTable;
+
+template <typename Engine>
+class BasicProofSolver;
+
+// How extra search threads are used
+enum class ParallelMode {
+    ROOT_SPLIT,   // root moves are shared out between the threads
+    LAZY_SMP      // every thread searches the whole tree; they meet in the
+                  // shared transposition table
+};
+
+// Minimax player for any BasicGameEngine instantiation, perfect when its
+// search is not limited: negamax with alpha-beta pruning, run on one engine
+// with make/undo so no node copies or allocates. Search results are kept in
+// a transposition table that persists across calls.
+template <typename Engine>
+class BasicAIOpponent {
 public:
-    AIOpponent() = default;
-    ~AIOpponent() = default;
+    using Board = typename Engine::Board;
+    // Called on the thread running calculateBestMove, just before it returns
+    using StatsCallback = std::function<void(const SearchStats&)>;
+
+    static constexpr int kDefaultThreatDepth = 4;
+
+    // Root moves in centre-distance order, which decides ties. Also the
+    // order both players pick a move on a finished board in.
+    static const std::array<int, Engine::kCells> kRootOrder;
+
+    explicit BasicAIOpponent(std::size_t tableCapacity = TranspositionTable::kDefaultCapacity);
+    ~BasicAIOpponent() = default;
+
+    BasicAIOpponent(const BasicAIOpponent&) = delete;
+    BasicAIOpponent& operator=(const BasicAIOpponent&) = delete;
+
+    // Calculate the best move for aiPlayer; {-1, -1} if the board is full
+    std::pair<int, int> calculateBestMove(const Board& board, Player aiPlayer);
+
+    // Best cell for the side to move, or -1 if the game is over
+    int calculateBestMove(const Engine& engine);
+
+    // Evaluate the current board state: 10 if aiPlayer has a line, -10 if
+    // the opponent has one, 0 otherwise
+    int evaluateBoard(const Board& board, Player aiPlayer) const;
+
+    TranspositionTable& getTranspositionTable();
+
+    void setSearchLimits(const SearchLimits& limits);
+    const SearchLimits& getSearchLimits() const;
+
+    // Threads per search, the calling thread included; 0 means one per
+    // hardware thread. Defaults to 1.
+    void setThreadCount(unsigned threadCount);
+    unsigned getThreadCount() const;
+
+    void setParallelMode(ParallelMode mode);
+    ParallelMode getParallelMode() const;
+
+    // Threats the search may chain past its horizon to find a forced win:
+    // each makes a line one stone short of complete, forcing a block, until
+    // one move makes two at once. 0 turns it off; by default it is on for
+    // boards of up to 64 cells, where listing those moves is cheap.
+    void setThreatDepth(int threats);
+    int getThreatDepth() const;
+
+    // Answer from a solved outcome table (see RetrogradeSolver) wherever it
+    // has a winning or drawing move; lost positions are still searched, to
+    // hold out longest. Boards the table type cannot cover ignore it;
+    // nullptr turns it off.
+    void setOutcomeTable(std::shared_ptr<const OutcomeTable<Engine>> table);
 
-    // Calculate the best move using minimax with alpha-beta pruning
-    std::pair<int, int> calculateBestMove(const std::array<std::array<Player, 3>, 3>& board, Player aiPlayer);
+    // Map a tablebase file written by OutcomeTable::save() and answer from
+    // it as above. Only the header is read here; the pages follow as
+    // positions are looked up. False, with the current table kept, if the
+    // file is unusable or not for this board.
+    bool openTablebase(const std::string& path);
+
+    // Before each search, try to prove a win for the side to move with
+    // this solver, within the solver's own limits, and play a proven win at
+    // once. Its nodes are reported as SearchStats::proofNodes, apart from
+    // the search's own; nullptr turns it off.
+    void setProofSolver(std::shared_ptr<BasicProofSolver<Engine>> solver);
+
+    // Counters of the last search; all zero if the game was already over
+    const SearchStats& getSearchStats() const;
+
+    // Called after every search with its stats, e.g. to feed a metrics
+    // sink; an empty callback turns it off
+    void setStatsCallback(StatsCallback callback);
+
+    // Positions visited by the last search, over all threads
+    std::uint64_t getNodeCount() const;
+
+    // Plies fully searched by the last search; for an exact solve, the
+    // number of empty cells
+    int getCompletedDepth() const;
 
 private:
-    // Minimax algorithm with alpha-beta pruning
-    int minimax(std::array<std::array<Player, 3>, 3> board, 
-                int depth, 
-                bool isMaximizing, 
-                int alpha, 
-                int beta, 
-                Player aiPlayer);
-
-    // Evaluate the current board state
-    int evaluateBoard(const std::array<std::array<Player, 3>, 3>& board, Player aiPlayer) const;
-
-    // Check if there are any empty cells left
-    bool hasEmptyCells(const std::array<std::array<Player, 3>, 3>& board) const;
-
-    // Get the opponent player
-    Player getOpponent(Player player) const;
+    using Clock = std::chrono::steady_clock;
+
+    // Search state owned by one thread; worker 0 runs on the caller
+    struct Worker {
+        Engine engine;
+        SearchStats stats;
+        std::uint64_t nextClockCheck = 0;
+    };
+
+    // Inner moves: cells on the most win lines first (3x3: centre, corners,
+    // edges), after the transposition table's best move
+    static const std::array<int, Engine::kCells> kMoveOrder;
+
+    // Time the search, collect the workers' stats and report them
+    int searchRoot();
+
+    // Book lookup, or the search itself with any helper threads
+    int chooseMove();
+
+    // Exact solve or iterative deepening from worker.engine. rootOffset
+    // rotates the root order so Lazy SMP helpers start on different moves.
+    int deepen(Worker& worker, int rootOffset, bool splitRoot);
+
+    // One pass over the root moves, `firstMove` (if any) first. Returns
+    // false if the search was stopped; bestMove is still set if some root
+    // move was searched to the end.
+    bool searchIteration(Worker& worker, int depth, int firstMove, int rootOffset, int& bestMove, int& bestScore);
+
+    // The same pass with the root moves shared out between all workers
+    bool searchIterationSplit(int depth, int firstMove, int& bestMove, int& bestScore);
+
+    // Score of worker.engine for the side to move, searched `depth` plies
+    // deep; ply counts moves from the root
+    int negamax(Worker& worker, int ply, int depth, int alpha, int beta);
+
+    // Score of the root move `cell`, or 0 if the search was stopped
+    int searchRootMove(Worker& worker, int cell, int depth, int alpha);
+
+    // Number of threats the side to move needs for a forced win, at most
+    // maxThreats, or 0 if none was found
+    int threatWin(Worker& worker, int maxThreats);
+
+    // Static score for the side to move at the search horizon
+    static int evaluatePosition(const Engine& engine);
+
+    bool outOfBudget(Worker& worker);
+
+    // Run task(worker) on every worker, helpers on the pool
+    template <typename Task>
+    void runOnWorkers(Task&& task);
+
+    Engine engine_;
+    TranspositionTable table_;
+    SearchLimits limits_;
+    ParallelMode parallelMode_;
+    std::vector<Worker> workers_;
+    std::unique_ptr<WorkStealingPool> helpers_;
+    Clock::time_point deadline_;
+    std::uint64_t nodeShare_;
+    std::atomic<bool> stop_;
+    int threatDepth_;
+    std::shared_ptr<const OutcomeTable<Engine>> outcomeTable_;
+    std::shared_ptr<BasicProofSolver<Engine>> proofSolver_;
+    SearchStats stats_;
+    StatsCallback statsCallback_;
 };
-} 
\ No newline at end of file
+
+using AIOpponent = BasicAIOpponent<ClassicGameEngine>;
+
+// Instantiated in ai_opponent.cpp
+extern template class BasicAIOpponent<ClassicGameEngine>;
+extern template class BasicAIOpponent<GameEngine4x4>;
+extern template class BasicAIOpponent<GameEngine5x5>;
+extern template class BasicAIOpponent<GameEngine6x6>;
+extern template class BasicAIOpponent<GomokuEngine>;
+extern template class BasicAIOpponent<QubicEngine>;
+
+} // namespace tictactoe
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "ai_opponent.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tictactoe {
+
+// Runs a move search on a background thread so an event loop never waits
+// for it. Searcher is BasicAIOpponent<Engine> or any player with the same
+// calculateBestMove(const Engine&) and setSearchLimits(); the search is
+// stopped through SearchLimits::cancel.
+//
+// Between moves it can ponder: search on the opponent's time the replies to
+// the moves the opponent is likely to play. A later start() on one of those
+// positions answers at once, and even a miss finds the searcher's
+// transposition table (or tree) warm.
+//
+// All members are meant for one owning thread, typically the GUI thread.
+template <typename Engine, typename Searcher = BasicAIOpponent<Engine>>
+class AsyncMoveSearch {
+public:
+    // Called on the search thread with the chosen cell, only if the search
+    // was not cancelled
+    using Callback = std::function<void(int)>;
+
+    AsyncMoveSearch();
+    ~AsyncMoveSearch();
+
+    AsyncMoveSearch(const AsyncMoveSearch&) = delete;
+    AsyncMoveSearch& operator=(const AsyncMoveSearch&) = delete;
+
+    // Search `position` (a copy is taken), cancelling any search still
+    // running. The future holds the chosen cell, or -1 if the search was
+    // cancelled or the game is over.
+    std::future<int> start(const Engine& position, Callback onDone = Callback());
+
+    // Search replies to the opponent's moves from `position`, where the
+    // opponent is to move, until the next start() or cancel(). The
+    // opponent's predicted move goes first, then the others in cell order.
+    void ponder(const Engine& position);
+
+    // Stop the running search or ponder, if any, and wait for its thread to
+    // finish; returns within a few hundred search nodes
+    void cancel();
+
+    bool isSearching() const;
+    bool isPondering() const;
+
+    // Replies finished by the current or last ponder
+    std::size_t getPonderedCount() const;
+    // start() calls answered from a ponder
+    std::uint64_t getPonderHits() const;
+
+    // The cancel field is managed here
+    void setSearchLimits(SearchLimits limits);
+
+    // For configuration while no search is running
+    Searcher& getSearcher();
+
+private:
+    struct PonderResult {
+        std::uint64_t key = 0;   // Zobrist key of the position searched
+        int move = -1;
+    };
+
+    Searcher searcher_;
+    std::atomic<bool> cancel_;
+    std::atomic<bool> searching_;
+    std::atomic<bool> pondering_;
+    // Written by the ponder thread, read by the owner only after a join
+    std::vector<PonderResult> ponderResults_;
+    std::atomic<std::size_t> ponderedCount_;
+    std::uint64_t ponderHits_;
+    std::thread thread_;
+};
+
+template <typename Engine, typename Searcher>
+AsyncMoveSearch<Engine, Searcher>::AsyncMoveSearch()
+    : cancel_(false)
+    , searching_(false)
+    , pondering_(false)
+    , ponderedCount_(0)
+    , ponderHits_(0)
+{
+    setSearchLimits(searcher_.getSearchLimits());
+}
+
+template <typename Engine, typename Searcher>
+AsyncMoveSearch<Engine, Searcher>::~AsyncMoveSearch()
+{
+    cancel();
+}
+
+template <typename Engine, typename Searcher>
+std::future<int> AsyncMoveSearch<Engine, Searcher>::start(const Engine& position, Callback onDone)
+{
+    cancel();
+
+    // A pondered reply to this very position needs no search
+    int pondered = -1;
+    for (const PonderResult& result : ponderResults_) {
+        if (result.key == position.getZobristKey() && result.move >= 0 &&
+            hasCell(position.getLegalMoves(), result.move)) {
+            pondered = result.move;
+            ++ponderHits_;
+            break;
+        }
+    }
+    ponderResults_.clear();
+
+    cancel_.store(false);
+    searching_.store(true);
+
+    std::promise<int> promise;
+    std::future<int> result = promise.get_future();
+    thread_ = std::thread([this, position, pondered, onDone = std::move(onDone), promise = std::move(promise)]() mutable {
+        const int move = (pondered >= 0) ? pondered : searcher_.calculateBestMove(position);
+        const bool cancelled = cancel_.load();
+        searching_.store(false);
+        promise.set_value(cancelled ? -1 : move);
+        if (!cancelled && onDone) {
+            onDone(move);
+        }
+    });
+    return result;
+}
+
+template <typename Engine, typename Searcher>
+void AsyncMoveSearch<Engine, Searcher>::ponder(const Engine& position)
+{
+    cancel();
+    ponderResults_.clear();
+    ponderedCount_.store(0);
+    if (position.isGameOver()) {
+        return;
+    }
+
+    cancel_.store(false);
+    pondering_.store(true);
+    thread_ = std::thread([this, position]() mutable {
+        Engine engine = position;
+
+        // Predicting the opponent's move also fills the searcher's table
+        // for the replies that follow
+        const int predicted = searcher_.calculateBestMove(engine);
+        auto others = engine.getLegalMoves();
+        for (int cell = predicted; cell >= 0 && !cancel_.load();) {
+            engine.makeMove(cell);
+            if (!engine.isGameOver()) {
+                const int move = searcher_.calculateBestMove(engine);
+                if (!cancel_.load()) {
+                    ponderResults_.push_back(PonderResult{engine.getZobristKey(), move});
+                    ponderedCount_.fetch_add(1);
+                }
+            }
+            engine.undoMove();
+
+            cell = -1;
+            while (!isEmptyMask(others) && cell < 0) {
+                const int next = popLowestCell(others);
+                cell = (next == predicted) ? -1 : next;
+            }
+        }
+        pondering_.store(false);
+    });
+}
+
+template <typename Engine, typename Searcher>
+void AsyncMoveSearch<Engine, Searcher>::cancel()
+{
+    if (!thread_.joinable()) {
+        return;
+    }
+    cancel_.store(true);
+    thread_.join();
+}
+
+template <typename Engine, typename Searcher>
+bool AsyncMoveSearch<Engine, Searcher>::isSearching() const
+{
+    return searching_.load();
+}
+
+template <typename Engine, typename Searcher>
+bool AsyncMoveSearch<Engine, Searcher>::isPondering() const
+{
+    return pondering_.load();
+}
+
+template <typename Engine, typename Searcher>
+std::size_t AsyncMoveSearch<Engine, Searcher>::getPonderedCount() const
+{
+    return ponderedCount_.load();
+}
+
+template <typename Engine, typename Searcher>
+std::uint64_t AsyncMoveSearch<Engine, Searcher>::getPonderHits() const
+{
+    return ponderHits_;
+}
+
+template <typename Engine, typename Searcher>
+void AsyncMoveSearch<Engine, Searcher>::setSearchLimits(SearchLimits limits)
+{
+    limits.cancel = &cancel_;
+    searcher_.setSearchLimits(limits);
+}
+
+template <typename Engine, typename Searcher>
+Searcher& AsyncMoveSearch<Engine, Searcher>::getSearcher()
+{
+    return searcher_;
+}
+
+} // namespace tictactoe
@@ -0,0 +1,446 @@
+#pragma once
+
+#include "bitmask.h"
+#include "win_lines.h"
+#include "zobrist.h"
+#include <array>
+#include <cstdint>
+
+namespace tictactoe {
+
+enum class Player {
+    NONE,
+    X,
+    O
+};
+
+enum class GameState {
+    IN_PROGRESS,
+    X_WON,
+    O_WON,
+    DRAW,
+    NONE    // no game: what a session pool reports for a stale handle
+};
+
+// Rules and state for K-in-a-row on an N x N board, or an N x N x N cube
+// for D = 3. Each player's stones are kept as a bitboard; cells are
+// numbered row * N + col, and (layer * N + row) * N + col in a cube. Per-line
+// stone counts, the Zobrist key and the position index are updated by every
+// move and undo, so neither game-end detection nor position identity needs
+// a scan of the board. So are the threats: empty cells that would complete
+// a line for one side.
+template <int N, int K = N, int D = 2>
+class BasicGameEngine {
+public:
+    static constexpr int kSize = N;
+    static constexpr int kWinLength = K;
+    static constexpr int kDimensions = D;
+    static constexpr int kCells = detail::cellCountOf(N, D);
+    static constexpr int kRows = kCells / N;
+
+    static_assert(K >= 2, "a threat needs a line of at least two cells");
+
+    using Mask = CellMask<kCells>;
+    // kRows rows of N cells; a cube's layers are stacked, so row
+    // layer * N + r is row r of that layer
+    using Board = std::array<std::array<Player, N>, kRows>;
+    using Lines = WinLines<N, K, D>;
+    using Zobrist = ZobristKeys<kCells>;
+
+    BasicGameEngine();
+
+    // Game control
+    bool makeMove(int row, int col);
+    bool makeMove(int cell);
+    bool undoMove();
+    void resetGame();
+
+    // Replace the position with the given board, `toMove` playing next
+    void setBoard(const Board& board, Player toMove);
+
+    // Game state
+    GameState getGameState() const;
+    Player getCurrentPlayer() const;
+    Board getBoard() const;
+    Player getCell(int cell) const;
+    bool isGameOver() const;
+    bool isValidMove(int row, int col) const;
+    int getMoveCount() const;
+    int getLastMove() const;
+
+    // Stones `player` has on win line `line` (an index into Lines)
+    int getLineCount(int line, Player player) const;
+
+    // Bitboard access
+    Mask getPlayerMask(Player player) const;
+    Mask getLegalMoves() const;
+    // Empty cells where `player` would complete a line
+    Mask getThreats(Player player) const;
+
+    // Position identity
+    std::uint64_t getZobristKey() const;
+    // Exact base-3 rank of the stones (side to move not included); only
+    // for boards of at most 40 cells
+    std::uint64_t getPositionIndex() const;
+
+    static constexpr Mask kFullBoard = fullMask<Mask>(kCells);
+    static constexpr bool kHasPositionIndex = PositionIndex<kCells>::kAvailable;
+
+private:
+    // Place a stone and update line counts; true if it completed a line
+    bool placeStone(int cell, Player player);
+    void removeStone(int cell, Player player);
+    bool checkDraw() const;
+    void switchPlayer();
+    void setCurrentPlayer(Player player);
+
+    // A line holding K - 1 stones of one side and none of the other is a
+    // threat on its empty cell; cells count the threat lines through them
+    void addThreat(int side, int cell);
+    void removeThreat(int side, int cell);
+    // The empty cell of `line` other than `except`
+    int emptyCellOf(int line, int except) const;
+
+    Mask xMask_;
+    Mask oMask_;
+    Player currentPlayer_;
+    GameState gameState_;
+    int moveCount_;
+    std::uint64_t zobristKey_;
+    std::uint64_t positionIndex_;
+    std::array<std::array<std::uint8_t, 2>, Lines::kCount> lineCounts_;
+    std::array<Mask, 2> threats_;
+    std::array<std::array<std::uint8_t, kCells>, 2> threatLines_;
+    std::array<std::uint8_t, kCells> moves_;
+};
+
+using ClassicGameEngine = BasicGameEngine<3, 3>;
+using GameEngine4x4 = BasicGameEngine<4, 4>;
+using GameEngine5x5 = BasicGameEngine<5, 4>;
+using GameEngine6x6 = BasicGameEngine<6, 4>;
+using GomokuEngine = BasicGameEngine<15, 5>;
+// Qubic: four in a row on a 4 x 4 x 4 cube, 76 lines
+using QubicEngine = BasicGameEngine<4, 4, 3>;
+
+template <int N, int K, int D>
+BasicGameEngine<N, K, D>::BasicGameEngine()
+{
+    resetGame();
+}
+
+template <int N, int K, int D>
+bool BasicGameEngine<N, K, D>::makeMove(int row, int col)
+{
+    if (row < 0 || row >= kRows || col < 0 || col >= N) {
+        return false;
+    }
+    return makeMove(row * N + col);
+}
+
+template <int N, int K, int D>
+bool BasicGameEngine<N, K, D>::makeMove(int cell)
+{
+    if (gameState_ != GameState::IN_PROGRESS || cell < 0 || cell >= kCells ||
+        !hasCell(getLegalMoves(), cell)) {
+        return false;
+    }
+
+    const Player mover = currentPlayer_;
+    const bool won = placeStone(cell, mover);
+    moves_[moveCount_++] = static_cast<std::uint8_t>(cell);
+
+    // Only the player who just moved can have completed a line
+    if (won) {
+        gameState_ = (mover == Player::X) ? GameState::X_WON : GameState::O_WON;
+    } else if (checkDraw()) {
+        gameState_ = GameState::DRAW;
+    } else {
+        switchPlayer();
+    }
+    return true;
+}
+
+template <int N, int K, int D>
+bool BasicGameEngine<N, K, D>::undoMove()
+{
+    if (moveCount_ == 0) {
+        return false;
+    }
+
+    const int cell = moves_[--moveCount_];
+    const Player mover = hasCell(xMask_, cell) ? Player::X : Player::O;
+    removeStone(cell, mover);
+
+    setCurrentPlayer(mover);
+    gameState_ = GameState::IN_PROGRESS;
+    return true;
+}
+
+template <int N, int K, int D>
+void BasicGameEngine<N, K, D>::resetGame()
+{
+    xMask_ = Mask{};
+    oMask_ = Mask{};
+    currentPlayer_ = Player::X;
+    gameState_ = GameState::IN_PROGRESS;
+    moveCount_ = 0;
+    zobristKey_ = 0;
+    positionIndex_ = 0;
+    for (auto& counts : lineCounts_) {
+        counts = {0, 0};
+    }
+    threats_ = {Mask{}, Mask{}};
+    for (auto& lines : threatLines_) {
+        lines.fill(0);
+    }
+}
+
+template <int N, int K, int D>
+void BasicGameEngine<N, K, D>::setBoard(const Board& board, Player toMove)
+{
+    resetGame();
+
+    // The board carries no move order; record the cells row by row so
+    // undoMove() can still take them back
+    bool xWon = false;
+    bool oWon = false;
+    for (int row = 0; row < kRows; ++row) {
+        for (int col = 0; col < N; ++col) {
+            const Player player = board[row][col];
+            if (player == Player::NONE) {
+                continue;
+            }
+            const bool won = placeStone(row * N + col, player);
+            (player == Player::X ? xWon : oWon) |= won;
+            moves_[moveCount_++] = static_cast<std::uint8_t>(row * N + col);
+        }
+    }
+
+    setCurrentPlayer(toMove);
+    if (xWon) {
+        gameState_ = GameState::X_WON;
+    } else if (oWon) {
+        gameState_ = GameState::O_WON;
+    } else if (checkDraw()) {
+        gameState_ = GameState::DRAW;
+    }
+}
+
+template <int N, int K, int D>
+GameState BasicGameEngine<N, K, D>::getGameState() const
+{
+    return gameState_;
+}
+
+template <int N, int K, int D>
+Player BasicGameEngine<N, K, D>::getCurrentPlayer() const
+{
+    return currentPlayer_;
+}
+
+template <int N, int K, int D>
+typename BasicGameEngine<N, K, D>::Board BasicGameEngine<N, K, D>::getBoard() const
+{
+    Board board;
+    for (int row = 0; row < kRows; ++row) {
+        for (int col = 0; col < N; ++col) {
+            board[row][col] = getCell(row * N + col);
+        }
+    }
+    return board;
+}
+
+template <int N, int K, int D>
+Player BasicGameEngine<N, K, D>::getCell(int cell) const
+{
+    if (hasCell(xMask_, cell)) {
+        return Player::X;
+    }
+    if (hasCell(oMask_, cell)) {
+        return Player::O;
+    }
+    return Player::NONE;
+}
+
+template <int N, int K, int D>
+bool BasicGameEngine<N, K, D>::isGameOver() const
+{
+    return gameState_ != GameState::IN_PROGRESS;
+}
+
+template <int N, int K, int D>
+bool BasicGameEngine<N, K, D>::isValidMove(int row, int col) const
+{
+    if (row < 0 || row >= kRows || col < 0 || col >= N) {
+        return false;
+    }
+    return hasCell(getLegalMoves(), row * N + col);
+}
+
+template <int N, int K, int D>
+int BasicGameEngine<N, K, D>::getMoveCount() const
+{
+    return moveCount_;
+}
+
+template <int N, int K, int D>
+int BasicGameEngine<N, K, D>::getLastMove() const
+{
+    return moveCount_ > 0 ? moves_[moveCount_ - 1] : -1;
+}
+
+template <int N, int K, int D>
+std::uint64_t BasicGameEngine<N, K, D>::getZobristKey() const
+{
+    return zobristKey_;
+}
+
+template <int N, int K, int D>
+std::uint64_t BasicGameEngine<N, K, D>::getPositionIndex() const
+{
+    static_assert(kHasPositionIndex, "3^cells does not fit in 64 bits; use getZobristKey()");
+    return positionIndex_;
+}
+
+template <int N, int K, int D>
+int BasicGameEngine<N, K, D>::getLineCount(int line, Player player) const
+{
+    return lineCounts_[line][player == Player::X ? 0 : 1];
+}
+
+template <int N, int K, int D>
+typename BasicGameEngine<N, K, D>::Mask BasicGameEngine<N, K, D>::getPlayerMask(Player player) const
+{
+    switch (player) {
+        case Player::X:
+            return xMask_;
+        case Player::O:
+            return oMask_;
+        default:
+            return static_cast<Mask>(kFullBoard & ~(xMask_ | oMask_));
+    }
+}
+
+template <int N, int K, int D>
+typename BasicGameEngine<N, K, D>::Mask BasicGameEngine<N, K, D>::getLegalMoves() const
+{
+    if (gameState_ != GameState::IN_PROGRESS) {
+        return Mask{};
+    }
+    return static_cast<Mask>(kFullBoard & ~(xMask_ | oMask_));
+}
+
+template <int N, int K, int D>
+typename BasicGameEngine<N, K, D>::Mask BasicGameEngine<N, K, D>::getThreats(Player player) const
+{
+    return threats_[player == Player::X ? 0 : 1];
+}
+
+template <int N, int K, int D>
+bool BasicGameEngine<N, K, D>::placeStone(int cell, Player player)
+{
+    const int side = (player == Player::X) ? 0 : 1;
+    const int other = 1 - side;
+    (side == 0 ? xMask_ : oMask_) |= maskOf<Mask>(cell);
+    zobristKey_ ^= Zobrist::kPieces[cell][side];
+    if constexpr (kHasPositionIndex) {
+        positionIndex_ += PositionIndex<kCells>::kPowers[cell] * static_cast<std::uint64_t>(side + 1);
+    }
+
+    // Threats only change on lines one stone short of K, so the common
+    // case costs one compare per line
+    bool completed = false;
+    const auto& lines = Lines::kByCell.lines[cell];
+    for (int i = 0; i < Lines::kByCell.counts[cell]; ++i) {
+        auto& counts = lineCounts_[lines[i]];
+        const int own = ++counts[side];
+        completed |= (own == K);
+        if (counts[other] == 0) {
+            if (own == K - 1) {
+                addThreat(side, emptyCellOf(lines[i], -1));
+            } else if (own == K) {
+                removeThreat(side, cell);
+            }
+        } else if (own == 1 && counts[other] == K - 1) {
+            removeThreat(other, cell);
+        }
+    }
+    return completed;
+}
+
+template <int N, int K, int D>
+void BasicGameEngine<N, K, D>::removeStone(int cell, Player player)
+{
+    const int side = (player == Player::X) ? 0 : 1;
+    (side == 0 ? xMask_ : oMask_) ^= maskOf<Mask>(cell);
+    zobristKey_ ^= Zobrist::kPieces[cell][side];
+    if constexpr (kHasPositionIndex) {
+        positionIndex_ -= PositionIndex<kCells>::kPowers[cell] * static_cast<std::uint64_t>(side + 1);
+    }
+
+    const int other = 1 - side;
+    const auto& lines = Lines::kByCell.lines[cell];
+    for (int i = 0; i < Lines::kByCell.counts[cell]; ++i) {
+        auto& counts = lineCounts_[lines[i]];
+        const int own = --counts[side];
+        if (counts[other] == 0) {
+            if (own == K - 1) {
+                addThreat(side, cell);
+            } else if (own == K - 2) {
+                removeThreat(side, emptyCellOf(lines[i], cell));
+            }
+        } else if (own == 0 && counts[other] == K - 1) {
+            addThreat(other, cell);
+        }
+    }
+}
+
+template <int N, int K, int D>
+void BasicGameEngine<N, K, D>::addThreat(int side, int cell)
+{
+    if (threatLines_[side][cell]++ == 0) {
+        threats_[side] |= maskOf<Mask>(cell);
+    }
+}
+
+template <int N, int K, int D>
+void BasicGameEngine<N, K, D>::removeThreat(int side, int cell)
+{
+    if (--threatLines_[side][cell] == 0) {
+        threats_[side] ^= maskOf<Mask>(cell);
+    }
+}
+
+template <int N, int K, int D>
+int BasicGameEngine<N, K, D>::emptyCellOf(int line, int except) const
+{
+    auto empty = static_cast<Mask>(Lines::kMasks[line] & ~(xMask_ | oMask_));
+    if (except >= 0) {
+        empty = static_cast<Mask>(empty & ~maskOf<Mask>(except));
+    }
+    return lowestCell(empty);
+}
+
+template <int N, int K, int D>
+bool BasicGameEngine<N, K, D>::checkDraw() const
+{
+    return moveCount_ == kCells;
+}
+
+template <int N, int K, int D>
+void BasicGameEngine<N, K, D>::switchPlayer()
+{
+    currentPlayer_ = (currentPlayer_ == Player::X) ? Player::O : Player::X;
+    zobristKey_ ^= Zobrist::kOToMove;
+}
+
+template <int N, int K, int D>
+void BasicGameEngine<N, K, D>::setCurrentPlayer(Player player)
+{
+    if ((currentPlayer_ == Player::O) != (player == Player::O)) {
+        zobristKey_ ^= Zobrist::kOToMove;
+    }
+    currentPlayer_ = player;
+}
+
+} // namespace tictactoe
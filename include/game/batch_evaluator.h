@@ -0,0 +1,87 @@
+#pragma once
+
+#include "basic_game_engine.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace tictactoe {
+
+// Boards for the batch evaluator, stored as one array of stone masks with
+// each board's X and O masks side by side (X first): 2 * sizeof(Mask)
+// bytes per board, read by the kernels as a flat run of masks.
+template <typename Mask>
+class BoardBatch {
+public:
+    void reserve(std::size_t count) { masks_.reserve(2 * count); }
+    void clear() { masks_.clear(); }
+
+    void add(Mask x, Mask o)
+    {
+        masks_.push_back(x);
+        masks_.push_back(o);
+    }
+
+    std::size_t size() const { return masks_.size() / 2; }
+    Mask getX(std::size_t board) const { return masks_[2 * board]; }
+    Mask getO(std::size_t board) const { return masks_[2 * board + 1]; }
+
+    // 2 * size() masks: X of board 0, O of board 0, X of board 1, ...
+    const Mask* data() const { return masks_.data(); }
+
+private:
+    std::vector<Mask> masks_;
+};
+
+// Instruction sets the batch kernels can use, weakest first
+enum class SimdLevel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Best level this CPU and build support; detected once
+SimdLevel detectSimdLevel();
+const char* describeSimdLevel(SimdLevel level);
+
+// Scores many independent boards at once: for each board, whether a side
+// has completed a line, whether the board is full, and a score of +10 for
+// an X line, -10 for an O line and 0 otherwise (evaluateBoard() from X's
+// side). A board with lines for both sides counts as won by X.
+//
+// Boards with 16- and 32-bit masks are tested against every win line with
+// SSE2 or AVX2, both stone masks of several boards per instruction; the
+// level is picked at run time. Wider boards use the scalar code.
+template <typename Engine>
+class BatchEvaluator {
+public:
+    using Mask = typename Engine::Mask;
+    using Batch = BoardBatch<Mask>;
+
+    explicit BatchEvaluator(SimdLevel level = detectSimdLevel());
+
+    // Fill states[i] and scores[i] for every board of the batch; either
+    // output may be nullptr if it is not needed
+    void evaluate(const Batch& boards, GameState* states, std::int8_t* scores) const;
+
+    // The level evaluate() uses: the one asked for, capped by what the
+    // CPU supports and what this board size has kernels for
+    SimdLevel getSimdLevel() const;
+
+    // Append the engine's board to the batch
+    static void pack(const Engine& engine, Batch& boards);
+
+private:
+    SimdLevel level_;
+};
+
+using ClassicBatchEvaluator = BatchEvaluator<ClassicGameEngine>;
+
+// Instantiated in batch_evaluator.cpp
+extern template class BatchEvaluator<ClassicGameEngine>;
+extern template class BatchEvaluator<GameEngine4x4>;
+extern template class BatchEvaluator<GameEngine5x5>;
+extern template class BatchEvaluator<GomokuEngine>;
+
+} // namespace tictactoe
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace tictactoe {
+
+// Bit tricks on 64-bit words
+inline int popCount64(std::uint64_t value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<int>(__popcnt64(value));
+#else
+    return __builtin_popcountll(value);
+#endif
+}
+
+// Index of the lowest set bit; value must not be zero
+inline int lowestBit64(std::uint64_t value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// Fixed-width bit set for boards with more than 64 cells. Unlike
+// std::bitset it is usable in constant expressions, so win-line masks for
+// large boards can still be generated at compile time.
+template <std::size_t Words>
+struct WideMask {
+    std::array<std::uint64_t, Words> words{};
+
+    constexpr WideMask& operator&=(const WideMask& other)
+    {
+        for (std::size_t i = 0; i < Words; ++i) {
+            words[i] &= other.words[i];
+        }
+        return *this;
+    }
+
+    constexpr WideMask& operator|=(const WideMask& other)
+    {
+        for (std::size_t i = 0; i < Words; ++i) {
+            words[i] |= other.words[i];
+        }
+        return *this;
+    }
+
+    constexpr WideMask& operator^=(const WideMask& other)
+    {
+        for (std::size_t i = 0; i < Words; ++i) {
+            words[i] ^= other.words[i];
+        }
+        return *this;
+    }
+
+    friend constexpr WideMask operator&(WideMask lhs, const WideMask& rhs) { return lhs &= rhs; }
+    friend constexpr WideMask operator|(WideMask lhs, const WideMask& rhs) { return lhs |= rhs; }
+    friend constexpr WideMask operator^(WideMask lhs, const WideMask& rhs) { return lhs ^= rhs; }
+
+    friend constexpr WideMask operator~(WideMask mask)
+    {
+        for (auto& word : mask.words) {
+            word = ~word;
+        }
+        return mask;
+    }
+
+    friend constexpr bool operator==(const WideMask& lhs, const WideMask& rhs)
+    {
+        for (std::size_t i = 0; i < Words; ++i) {
+            if (lhs.words[i] != rhs.words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend constexpr bool operator!=(const WideMask& lhs, const WideMask& rhs) { return !(lhs == rhs); }
+};
+
+// Smallest mask type with at least Cells bits
+template <std::size_t Cells>
+using CellMask =
+    std::conditional_t<(Cells <= 16), std::uint16_t,
+    std::conditional_t<(Cells <= 32), std::uint32_t,
+    std::conditional_t<(Cells <= 64), std::uint64_t,
+                       WideMask<(Cells + 63) / 64>>>>;
+
+template <typename Mask>
+constexpr Mask maskOf(int cell)
+{
+    if constexpr (std::is_integral_v<Mask>) {
+        return static_cast<Mask>(std::uint64_t{1} << cell);
+    } else {
+        Mask mask{};
+        mask.words[cell / 64] = std::uint64_t{1} << (cell % 64);
+        return mask;
+    }
+}
+
+// Mask with the lowest `cells` bits set
+template <typename Mask>
+constexpr Mask fullMask(int cells)
+{
+    Mask mask{};
+    for (int cell = 0; cell < cells; ++cell) {
+        mask |= maskOf<Mask>(cell);
+    }
+    return mask;
+}
+
+template <typename Mask>
+constexpr bool hasCell(const Mask& mask, int cell)
+{
+    if constexpr (std::is_integral_v<Mask>) {
+        return ((mask >> cell) & 1u) != 0;
+    } else {
+        return ((mask.words[cell / 64] >> (cell % 64)) & 1u) != 0;
+    }
+}
+
+template <typename Mask>
+constexpr bool isEmptyMask(const Mask& mask)
+{
+    return mask == Mask{};
+}
+
+template <typename Mask>
+inline int cellCount(const Mask& mask)
+{
+    if constexpr (std::is_integral_v<Mask>) {
+        return popCount64(mask);
+    } else {
+        int count = 0;
+        for (auto word : mask.words) {
+            count += popCount64(word);
+        }
+        return count;
+    }
+}
+
+// Lowest occupied cell; mask must not be empty
+template <typename Mask>
+inline int lowestCell(const Mask& mask)
+{
+    if constexpr (std::is_integral_v<Mask>) {
+        return lowestBit64(mask);
+    } else {
+        std::size_t i = 0;
+        while (mask.words[i] == 0) {
+            ++i;
+        }
+        return static_cast<int>(i * 64) + lowestBit64(mask.words[i]);
+    }
+}
+
+// Remove and return the lowest occupied cell; mask must not be empty
+template <typename Mask>
+inline int popLowestCell(Mask& mask)
+{
+    if constexpr (std::is_integral_v<Mask>) {
+        const int cell = lowestBit64(mask);
+        mask = static_cast<Mask>(mask & (mask - 1));
+        return cell;
+    } else {
+        std::size_t i = 0;
+        while (mask.words[i] == 0) {
+            ++i;
+        }
+        const int cell = static_cast<int>(i * 64) + lowestBit64(mask.words[i]);
+        mask.words[i] &= mask.words[i] - 1;
+        return cell;
+    }
+}
+
+} // namespace tictactoe
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "basic_game_engine.h"
+#include <cstdint>
+
+namespace tictactoe {
+
+// Perfect play for the 3x3 game, solved at compile time. Every position with
+// a legal stone count (X to move when the counts are equal, O when X has one
+// more) has an entry, looked up by ClassicGameEngine::getPositionIndex().
+class ClassicSolution {
+public:
+    struct Entry {
+        // Best cell, or -1 when the game is over or the stone counts are
+        // not legal. Ties go to the cell nearest the centre.
+        std::int8_t move;
+
+        // For the side to move: 10 - p for a win in p plies, p - 10 for a
+        // loss in p plies, 0 for a draw
+        std::int8_t score;
+    };
+
+    static constexpr int kPositions = 19683;   // 3^9
+
+    static Entry lookup(std::uint64_t positionIndex);
+    static Entry lookup(const ClassicGameEngine& engine);
+};
+
+} // namespace tictactoe
@@ -0,0 +1,293 @@
+#pragma once
+
+#include "basic_game_engine.h"
+#include "ai_opponent.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tictactoe {
+
+// Stable reference to a session. A slot is reused after destroy(), but its
+// generation changes, so stale handles are rejected.
+struct SessionHandle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+
+    friend bool operator==(SessionHandle lhs, SessionHandle rhs)
+    {
+        return lhs.index == rhs.index && lhs.generation == rhs.generation;
+    }
+    friend bool operator!=(SessionHandle lhs, SessionHandle rhs) { return !(lhs == rhs); }
+};
+
+// Many independent games stored as parallel arrays (structure of arrays).
+// Bulk passes such as advanceAI() stream through the byte-sized player and
+// state columns without touching the boards of sessions they skip.
+template <typename Engine>
+class BasicGameSessionPool {
+public:
+    using Mask = typename Engine::Mask;
+    using Lines = typename Engine::Lines;
+
+    explicit BasicGameSessionPool(std::size_t capacity = 0);
+
+    // aiPlayer is the side advanceAI() moves for, or NONE for none
+    SessionHandle create(Player aiPlayer = Player::NONE);
+    bool destroy(SessionHandle handle);
+    bool isValid(SessionHandle handle) const;
+    std::size_t size() const;
+
+    bool makeMove(SessionHandle handle, int cell);
+    bool reset(SessionHandle handle);
+
+    // A stale or unknown handle has no game: its state is GameState::NONE,
+    // its players NONE, its masks empty and its move count -1
+    GameState getGameState(SessionHandle handle) const;
+    Player getCurrentPlayer(SessionHandle handle) const;
+    Player getAIPlayer(SessionHandle handle) const;
+    Mask getPlayerMask(SessionHandle handle, Player player) const;
+    int getMoveCount(SessionHandle handle) const;
+
+    // Let the AI move in every live session where it is the AI's turn.
+    // chooseMove(xMask, oMask, toMove) must return a legal cell. Returns
+    // the number of moves made.
+    template <typename ChooseMove>
+    std::size_t advanceAI(ChooseMove&& chooseMove);
+
+    // Same, with moves chosen by a minimax player
+    std::size_t advanceAI(BasicAIOpponent<Engine>& ai);
+
+private:
+    void applyMove(std::uint32_t index, int cell);
+    bool completesLine(const Mask& mask, int cell) const;
+
+    // Hot columns for bulk passes
+    std::vector<std::uint8_t> currentPlayers_;
+    std::vector<std::uint8_t> aiPlayers_;
+    std::vector<std::uint8_t> states_;
+    std::vector<std::uint8_t> moveCounts_;
+
+    // Boards
+    std::vector<Mask> xMasks_;
+    std::vector<Mask> oMasks_;
+
+    // Slot bookkeeping
+    std::vector<std::uint32_t> generations_;
+    std::vector<std::uint8_t> alive_;
+    std::vector<std::uint32_t> freeSlots_;
+    std::size_t liveCount_;
+};
+
+using GameSessionPool = BasicGameSessionPool<ClassicGameEngine>;
+
+template <typename Engine>
+BasicGameSessionPool<Engine>::BasicGameSessionPool(std::size_t capacity)
+    : liveCount_(0)
+{
+    currentPlayers_.reserve(capacity);
+    aiPlayers_.reserve(capacity);
+    states_.reserve(capacity);
+    moveCounts_.reserve(capacity);
+    xMasks_.reserve(capacity);
+    oMasks_.reserve(capacity);
+    generations_.reserve(capacity);
+    alive_.reserve(capacity);
+}
+
+template <typename Engine>
+SessionHandle BasicGameSessionPool<Engine>::create(Player aiPlayer)
+{
+    std::uint32_t index;
+    if (!freeSlots_.empty()) {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        index = static_cast<std::uint32_t>(alive_.size());
+        currentPlayers_.push_back(0);
+        aiPlayers_.push_back(0);
+        states_.push_back(0);
+        moveCounts_.push_back(0);
+        xMasks_.push_back(Mask{});
+        oMasks_.push_back(Mask{});
+        generations_.push_back(0);
+        alive_.push_back(0);
+    }
+
+    alive_[index] = 1;
+    aiPlayers_[index] = static_cast<std::uint8_t>(aiPlayer);
+    ++liveCount_;
+
+    SessionHandle handle{index, generations_[index]};
+    reset(handle);
+    return handle;
+}
+
+template <typename Engine>
+bool BasicGameSessionPool<Engine>::destroy(SessionHandle handle)
+{
+    if (!isValid(handle)) {
+        return false;
+    }
+    alive_[handle.index] = 0;
+    ++generations_[handle.index];
+    freeSlots_.push_back(handle.index);
+    --liveCount_;
+    return true;
+}
+
+template <typename Engine>
+bool BasicGameSessionPool<Engine>::isValid(SessionHandle handle) const
+{
+    return handle.index < alive_.size() && alive_[handle.index] &&
+           generations_[handle.index] == handle.generation;
+}
+
+template <typename Engine>
+std::size_t BasicGameSessionPool<Engine>::size() const
+{
+    return liveCount_;
+}
+
+template <typename Engine>
+bool BasicGameSessionPool<Engine>::makeMove(SessionHandle handle, int cell)
+{
+    if (!isValid(handle) || cell < 0 || cell >= Engine::kCells) {
+        return false;
+    }
+
+    const std::uint32_t index = handle.index;
+    if (states_[index] != static_cast<std::uint8_t>(GameState::IN_PROGRESS) ||
+        hasCell(static_cast<Mask>(xMasks_[index] | oMasks_[index]), cell)) {
+        return false;
+    }
+
+    applyMove(index, cell);
+    return true;
+}
+
+template <typename Engine>
+bool BasicGameSessionPool<Engine>::reset(SessionHandle handle)
+{
+    if (!isValid(handle)) {
+        return false;
+    }
+    const std::uint32_t index = handle.index;
+    currentPlayers_[index] = static_cast<std::uint8_t>(Player::X);
+    states_[index] = static_cast<std::uint8_t>(GameState::IN_PROGRESS);
+    moveCounts_[index] = 0;
+    xMasks_[index] = Mask{};
+    oMasks_[index] = Mask{};
+    return true;
+}
+
+template <typename Engine>
+GameState BasicGameSessionPool<Engine>::getGameState(SessionHandle handle) const
+{
+    if (!isValid(handle)) {
+        return GameState::NONE;
+    }
+    return static_cast<GameState>(states_[handle.index]);
+}
+
+template <typename Engine>
+Player BasicGameSessionPool<Engine>::getCurrentPlayer(SessionHandle handle) const
+{
+    if (!isValid(handle)) {
+        return Player::NONE;
+    }
+    return static_cast<Player>(currentPlayers_[handle.index]);
+}
+
+template <typename Engine>
+Player BasicGameSessionPool<Engine>::getAIPlayer(SessionHandle handle) const
+{
+    if (!isValid(handle)) {
+        return Player::NONE;
+    }
+    return static_cast<Player>(aiPlayers_[handle.index]);
+}
+
+template <typename Engine>
+typename BasicGameSessionPool<Engine>::Mask BasicGameSessionPool<Engine>::getPlayerMask(SessionHandle handle, Player player) const
+{
+    if (!isValid(handle)) {
+        return Mask{};
+    }
+    return (player == Player::X) ? xMasks_[handle.index] : oMasks_[handle.index];
+}
+
+template <typename Engine>
+int BasicGameSessionPool<Engine>::getMoveCount(SessionHandle handle) const
+{
+    if (!isValid(handle)) {
+        return -1;
+    }
+    return moveCounts_[handle.index];
+}
+
+template <typename Engine>
+template <typename ChooseMove>
+std::size_t BasicGameSessionPool<Engine>::advanceAI(ChooseMove&& chooseMove)
+{
+    constexpr auto kInProgress = static_cast<std::uint8_t>(GameState::IN_PROGRESS);
+
+    std::size_t moved = 0;
+    const std::size_t count = alive_.size();
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!alive_[i] || states_[i] != kInProgress || currentPlayers_[i] != aiPlayers_[i]) {
+            continue;
+        }
+        const auto index = static_cast<std::uint32_t>(i);
+        const int cell = chooseMove(xMasks_[index], oMasks_[index], static_cast<Player>(currentPlayers_[index]));
+        applyMove(index, cell);
+        ++moved;
+    }
+    return moved;
+}
+
+template <typename Engine>
+std::size_t BasicGameSessionPool<Engine>::advanceAI(BasicAIOpponent<Engine>& ai)
+{
+    return advanceAI([&ai](const Mask& xMask, const Mask& oMask, Player toMove) {
+        typename Engine::Board board;
+        for (int cell = 0; cell < Engine::kCells; ++cell) {
+            Player& slot = board[cell / Engine::kSize][cell % Engine::kSize];
+            slot = hasCell(xMask, cell) ? Player::X : (hasCell(oMask, cell) ? Player::O : Player::NONE);
+        }
+        const auto move = ai.calculateBestMove(board, toMove);
+        return move.first * Engine::kSize + move.second;
+    });
+}
+
+template <typename Engine>
+void BasicGameSessionPool<Engine>::applyMove(std::uint32_t index, int cell)
+{
+    const auto mover = static_cast<Player>(currentPlayers_[index]);
+    Mask& mask = (mover == Player::X) ? xMasks_[index] : oMasks_[index];
+    mask |= maskOf<Mask>(cell);
+    ++moveCounts_[index];
+
+    if (completesLine(mask, cell)) {
+        states_[index] = static_cast<std::uint8_t>(mover == Player::X ? GameState::X_WON : GameState::O_WON);
+    } else if (moveCounts_[index] == Engine::kCells) {
+        states_[index] = static_cast<std::uint8_t>(GameState::DRAW);
+    } else {
+        currentPlayers_[index] = static_cast<std::uint8_t>(mover == Player::X ? Player::O : Player::X);
+    }
+}
+
+template <typename Engine>
+bool BasicGameSessionPool<Engine>::completesLine(const Mask& mask, int cell) const
+{
+    const auto& lines = Lines::kByCell.lines[cell];
+    for (int i = 0; i < Lines::kByCell.counts[cell]; ++i) {
+        const Mask& line = Lines::kMasks[lines[i]];
+        if ((mask & line) == line) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace tictactoe
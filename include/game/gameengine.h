@@ -1,57 +1,100 @@
 #pragma once
 
-#include <array>
 #include <string>
 #include <memory>
 #include <QObject>
+#include "basic_game_engine.h"
+#include "async_move_search.h"
 
 namespace tictactoe {
 
-enum class Player {
-    NONE,
-    X,
-    O
-};
+// One bit per cell, bit index = row * 3 + col
+using BoardMask = ClassicGameEngine::Mask;
 
-enum class GameState {
-    IN_PROGRESS,
-    X_WON,
-    O_WON,
-    DRAW
+// Everything a listener needs to know about one applied move
+struct MoveDelta {
+    int cell = -1;                          // row * kBoardSize + col
+    Player player = Player::NONE;           // who moved
+    GameState state = GameState::IN_PROGRESS;
+    Player nextPlayer = Player::NONE;       // NONE once the game is over
 };
 
+// Qt front end for the headless ClassicGameEngine. Search and batch code
+// should drive core() directly and skip the signal dispatch.
+//
+// In vs-AI mode the AI plays O. Its move is searched on a background
+// thread and applied back on this object's thread through the event loop,
+// so the GUI never blocks on it; resetGame(), leaving vs-AI mode and
+// destruction cancel a search still running. While the human thinks, the
+// AI ponders their likely moves (see AsyncMoveSearch::ponder()).
 class GameEngine : public QObject {
     Q_OBJECT
 
 public:
+    static constexpr int kBoardSize = ClassicGameEngine::kSize;
+    using Board = ClassicGameEngine::Board;
+
+    static constexpr Player kAIPlayer = Player::O;
+
     explicit GameEngine(QObject* parent = nullptr);
-    ~GameEngine() = default;
+    ~GameEngine();
 
-    // Game control
+    // Game control. makeMove() is the human player's move; it is refused
+    // while the AI is thinking.
     bool makeMove(int row, int col);
     void resetGame();
     void setGameMode(bool isVsAI);
+    bool isVsAI() const;
+
+    // AI control
+    bool isAIThinking() const;
+    void cancelAIMove();
+    void setAISearchLimits(const SearchLimits& limits);
+    // On by default
+    void setPondering(bool enabled);
+    bool isPonderingEnabled() const;
 
     // Game state
     GameState getGameState() const;
     Player getCurrentPlayer() const;
-    const std::array<std::array<Player, 3>, 3>& getBoard() const;
+    Board getBoard() const;
     bool isGameOver() const;
 
+    // Bitboard access
+    BoardMask getPlayerMask(Player player) const;
+    BoardMask getLegalMoves() const;
+
+    // Position identity, maintained incrementally by the core engine
+    std::uint64_t getZobristKey() const;
+    std::uint64_t getPositionIndex() const;
+
+    // The underlying rules engine
+    const ClassicGameEngine& core() const;
+
 signals:
-    void gameStateChanged(GameState newState);
-    void currentPlayerChanged(Player newPlayer);
-    void boardChanged();
-    void gameOver(GameState finalState);
+    // Emitted once per successful makeMove()
+    void moveApplied(const tictactoe::MoveDelta& delta);
+    // Emitted after resetGame(); listeners should redraw from scratch
+    void gameReset();
+    // Emitted when an AI search starts and when it ends or is cancelled
+    void aiThinkingChanged(bool thinking);
 
 private:
-    bool checkWin() const;
-    bool checkDraw() const;
-    void switchPlayer();
-    bool isValidMove(int row, int col) const;
-
-    std::array<std::array<Player, 3>, 3> board_;
-    Player currentPlayer_;
-    GameState gameState_;
+    bool applyMove(int cell);
+    void startAIMoveIfDue();
+    void onAIMoveReady(quint64 request, int cell);
+    void setAIThinking(bool thinking);
+
+    ClassicGameEngine engine_;
     bool isVsAI_;
-}; 
\ No newline at end of file
+    bool pondering_;
+    AsyncMoveSearch<ClassicGameEngine> ai_;
+    // Bumped whenever a search starts or is cancelled, so a move that was
+    // already queued when its search went stale is dropped
+    quint64 aiRequest_;
+    bool aiThinking_;
+};
+
+} // namespace tictactoe
+
+Q_DECLARE_METATYPE(tictactoe::MoveDelta)
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "basic_game_engine.h"
+#include "ai_opponent.h"
+#include "node_arena.h"
+#include "concurrency/work_stealing_pool.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace tictactoe {
+
+// How a tree node picks the child to walk into
+enum class SelectionRule {
+    UCT,    // mean result plus c * sqrt(ln N / n); unvisited children first
+    PUCT    // mean result plus c * prior * sqrt(N) / (1 + n), priors from
+            // the win lines each cell helps or blocks
+};
+
+// Monte Carlo tree search player for any BasicGameEngine instantiation, for
+// boards too large to search with minimax. It has the same move interface
+// as BasicAIOpponent, so callers can use either.
+//
+// Tree nodes come from a NodeArena that is reset on every move. With tree
+// reuse on, the subtree for the new position is copied into a second arena
+// first, so the statistics gathered for it survive. With several threads
+// every thread grows its own tree (root parallelization) and the root visit
+// counts are summed to choose the move.
+template <typename Engine>
+class BasicMCTSOpponent {
+public:
+    using Board = typename Engine::Board;
+
+    // Playouts per move when the search limits set neither a time nor a
+    // node budget
+    static constexpr std::uint64_t kDefaultPlayouts = 20000;
+    // Tree memory per thread after which leaves are played out but no
+    // longer expanded
+    static constexpr std::size_t kDefaultMaxTreeBytes = std::size_t(256) << 20;
+
+    BasicMCTSOpponent();
+    ~BasicMCTSOpponent() = default;
+
+    BasicMCTSOpponent(const BasicMCTSOpponent&) = delete;
+    BasicMCTSOpponent& operator=(const BasicMCTSOpponent&) = delete;
+
+    // Calculate the best move for aiPlayer; {-1, -1} if the board is full
+    std::pair<int, int> calculateBestMove(const Board& board, Player aiPlayer);
+
+    // Best cell for the side to move, or -1 if the game is over
+    int calculateBestMove(const Engine& engine);
+
+    // moveTime, maxNodes (counted in playouts, over all threads) and cancel
+    // bound the search; maxDepth is ignored
+    void setSearchLimits(const SearchLimits& limits);
+    const SearchLimits& getSearchLimits() const;
+
+    // Threads per search, the calling thread included; 0 means one per
+    // hardware thread. Defaults to 1.
+    void setThreadCount(unsigned threadCount);
+    unsigned getThreadCount() const;
+
+    void setSelectionRule(SelectionRule rule);
+    SelectionRule getSelectionRule() const;
+
+    // The c above; defaults to 1.4
+    void setExplorationConstant(double exploration);
+    double getExplorationConstant() const;
+
+    // Keep the subtree of the new position between moves; on by default
+    void setTreeReuse(bool enabled);
+    bool isTreeReuseEnabled() const;
+
+    void setMaxTreeBytes(std::size_t bytes);
+    std::size_t getMaxTreeBytes() const;
+
+    // Reseed every thread's playout generator
+    void setSeed(std::uint64_t seed);
+
+    // Playouts run by the last search, over all threads
+    std::uint64_t getPlayoutCount() const;
+    double getPlayoutsPerSecond() const;
+
+    // Root visits carried over from the previous move by tree reuse
+    std::uint64_t getReusedPlayouts() const;
+
+    // Arena bytes held by the current trees
+    std::size_t getTreeBytes() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Node {
+        Node* children = nullptr;
+        std::uint32_t visits = 0;
+        // Results in half points (win 2, draw 1) for the player whose move
+        // led to this node
+        std::uint32_t score = 0;
+        float prior = 0.0f;
+        std::int16_t move = -1;
+        std::int16_t childCount = -1;   // -1 until expanded
+    };
+
+    // One search tree and the state of the thread that grows it
+    struct Tree {
+        std::array<NodeArena, 2> arenas;
+        int active = 0;
+        Node* root = nullptr;
+        Engine rootEngine;
+        Engine engine;
+        std::mt19937_64 rng;
+        std::uint64_t playouts = 0;
+        std::uint64_t reused = 0;
+    };
+
+    int searchRoot();
+
+    // Point tree.root at engine_, reusing what it already knows
+    void prepareRoot(Tree& tree);
+    Node* findSubtree(const Tree& tree) const;
+    void copyChildren(Node& target, const Node& source, NodeArena& arena) const;
+
+    void runPlayouts(Tree& tree, std::uint64_t budget);
+    void expand(Tree& tree, Node& node) const;
+    Node* select(const Node& node) const;
+    // Finish the game with uniformly random moves
+    static void playOut(Tree& tree);
+
+    bool outOfTime() const;
+
+    // Run task(tree) on every tree, helpers on the pool
+    template <typename Task>
+    void runOnTrees(Task&& task);
+
+    Engine engine_;
+    SearchLimits limits_;
+    SelectionRule rule_;
+    double exploration_;
+    bool treeReuse_;
+    std::size_t maxTreeBytes_;
+    std::uint64_t seed_;
+    std::vector<Tree> trees_;
+    std::unique_ptr<WorkStealingPool> helpers_;
+    Clock::time_point deadline_;
+    double playoutsPerSecond_;
+};
+
+using MCTSOpponent = BasicMCTSOpponent<ClassicGameEngine>;
+
+// Instantiated in mcts_opponent.cpp
+extern template class BasicMCTSOpponent<ClassicGameEngine>;
+extern template class BasicMCTSOpponent<GameEngine4x4>;
+extern template class BasicMCTSOpponent<GameEngine5x5>;
+extern template class BasicMCTSOpponent<GomokuEngine>;
+
+} // namespace tictactoe
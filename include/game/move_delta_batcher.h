@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include "gameengine.h"
+
+namespace tictactoe {
+
+// Collects GameEngine::moveApplied deltas and hands them on once per pass
+// of the event loop, so a burst of programmatic moves costs listeners a
+// single update.
+class MoveDeltaBatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit MoveDeltaBatcher(GameEngine* engine, QObject* parent = nullptr);
+    ~MoveDeltaBatcher() = default;
+
+signals:
+    // Deltas in the order the moves were applied
+    void movesApplied(const QVector<tictactoe::MoveDelta>& deltas);
+
+private slots:
+    void onMoveApplied(const tictactoe::MoveDelta& delta);
+    void onGameReset();
+    void flush();
+
+private:
+    QVector<MoveDelta> pending_;
+    bool flushScheduled_;
+};
+
+} // namespace tictactoe
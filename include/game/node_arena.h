@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tictactoe {
+
+// Bump allocator for search trees. Objects are carved out of large blocks
+// and never freed one by one; reset() drops them all at once and keeps the
+// blocks for the next search, so a warmed-up arena does not allocate.
+// Only trivially destructible types may be created, since no destructors
+// run.
+class NodeArena {
+public:
+    static constexpr std::size_t kDefaultBlockSize = std::size_t(1) << 20;
+
+    explicit NodeArena(std::size_t blockSize = kDefaultBlockSize);
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+    NodeArena(NodeArena&&) = default;
+    NodeArena& operator=(NodeArena&&) = default;
+
+    // Raw storage; never returns nullptr
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args);
+
+    // `count` value-initialized objects
+    template <typename T>
+    T* createArray(std::size_t count);
+
+    // Forget every object; the blocks are kept
+    void reset();
+
+    // Bytes handed out since the last reset, and bytes held in blocks
+    std::size_t getBytesUsed() const;
+    std::size_t getBytesReserved() const;
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        std::size_t size = 0;
+    };
+
+    std::vector<Block> blocks_;
+    std::size_t blockSize_;
+    std::size_t current_;
+    std::size_t offset_;
+    std::size_t used_;
+};
+
+template <typename T, typename... Args>
+T* NodeArena::create(Args&&... args)
+{
+    static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+T* NodeArena::createArray(std::size_t count)
+{
+    static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+    T* objects = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    for (std::size_t i = 0; i < count; ++i) {
+        new (objects + i) T();
+    }
+    return objects;
+}
+
+} // namespace tictactoe
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "ai_opponent.h"
+#include "basic_game_engine.h"
+#include "retrograde_solver.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace tictactoe {
+
+// Result of one proof attempt
+enum class ProofResult {
+    PROVEN,      // the attacker can force a win
+    DISPROVEN,   // the defender can always hold at least a draw
+    UNKNOWN      // the search ran out of budget first
+};
+
+// Snapshot of a running proof, for progress reports
+struct ProofProgress {
+    Player attacker = Player::X;        // side whose win is being proven
+    std::uint32_t proofNumber = 0;      // root proof number; 0 once proven
+    std::uint32_t disproofNumber = 0;   // root disproof number; 0 once disproven
+    std::uint64_t nodes = 0;            // positions expanded so far
+    std::size_t tableEntries = 0;       // hash table entries in use
+    std::size_t tableCapacity = 0;
+    std::chrono::microseconds elapsed{0};
+};
+
+// Depth-first proof-number search (df-pn) for boards too large to solve by
+// minimax or by retrograde analysis. Each proof asks whether one side, the
+// attacker, can force a line; the defender wins the proof by drawing or by
+// making a line of its own. solve() settles a position with at most two
+// proofs: a win for the side to move, then a win for the opponent.
+//
+// Proof and disproof numbers are kept in a hash table of fixed size. When a
+// bucket is full, the entry whose subtree took the least work to settle is
+// replaced, so large proofs run in bounded memory at the cost of some
+// re-search.
+//
+// Leaves are cut short with the engine's threat masks: the side to move
+// wins at once with a threat of its own, loses to two threats of the
+// opponent and must block a single one. A proof also fails as soon as no
+// line is left open for the attacker, and cells on no open line of either
+// side are never tried, which settles most drawn endgames early.
+template <typename Engine>
+class BasicProofSolver {
+public:
+    using Mask = typename Engine::Mask;
+    // Called on the thread running the proof, every progress interval and
+    // once when each proof ends
+    using ProgressCallback = std::function<void(const ProofProgress&)>;
+
+    static constexpr std::size_t kDefaultTableBytes = std::size_t{64} << 20;
+    static constexpr std::uint64_t kDefaultProgressInterval = 1 << 20;
+    // Proof and disproof numbers saturate here
+    static constexpr std::uint32_t kInfinity = 0x7FFFFFFFu;
+
+    // The table holds as many entries as fit in tableBytes, at least 4
+    explicit BasicProofSolver(std::size_t tableBytes = kDefaultTableBytes);
+
+    BasicProofSolver(const BasicProofSolver&) = delete;
+    BasicProofSolver& operator=(const BasicProofSolver&) = delete;
+
+    // Whether `attacker` can force a win from this position
+    ProofResult prove(const Engine& engine, Player attacker);
+
+    // Value of the position for the side to move, or UNKNOWN if the
+    // budget runs out first. A finished game is a LOSS after a line and a
+    // DRAW on a full board.
+    Outcome solve(const Engine& engine);
+
+    // A move that keeps the result of the last prove() or solve() for the
+    // side to move: the winning move of a win, a holding move of a draw or
+    // of a disproof by the defender. -1 otherwise.
+    int getProvenMove() const;
+
+    // moveTime, maxNodes and cancel bound each prove() or solve() call;
+    // maxDepth is not used
+    void setSearchLimits(const SearchLimits& limits);
+    const SearchLimits& getSearchLimits() const;
+
+    // An empty callback turns progress reports off
+    void setProgressCallback(ProgressCallback callback,
+                             std::uint64_t intervalNodes = kDefaultProgressInterval);
+
+    // Positions expanded by the last prove() or solve()
+    std::uint64_t getNodeCount() const;
+
+    std::size_t getTableCapacity() const;
+    std::size_t getTableUsage() const;
+    // Forget every stored result
+    void clearTable();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::uint64_t key = 0;
+        std::uint32_t phi = 0;
+        std::uint32_t delta = 0;
+        // Nodes expanded to reach these numbers; 0 marks an empty slot
+        std::uint64_t work = 0;
+    };
+
+    static constexpr std::size_t kBucketSize = 4;
+
+    // Cells in the order children are tried: on the most win lines first
+    static const std::array<int, Engine::kCells> kMoveOrder;
+
+    // Run one proof from engine_; keeps the node count and clock of the
+    // call it belongs to
+    ProofResult proveFrom(Player attacker);
+
+    // Expand the node with key `key`, `mover` to play, until its numbers
+    // reach either threshold. Numbers are from the mover's side: phi proves
+    // its goal (a win if it attacks, a draw or better if it defends) and
+    // delta refutes it.
+    void search(std::uint64_t key, Player mover, int ply, std::uint32_t thresholdPhi,
+                std::uint32_t thresholdDelta, std::uint32_t& phi, std::uint32_t& delta);
+
+    // Numbers of a settled node, or false with the moves to try in
+    // `children`. `move` is a cell that reaches the goal when there is one.
+    bool evaluateLeaf(Player mover, std::uint32_t& phi, std::uint32_t& delta, Mask& children, int& move) const;
+
+    // Stored numbers of `key`, or 1 and 1 for an unseen node
+    void lookup(std::uint64_t key, std::uint32_t& phi, std::uint32_t& delta) const;
+    void store(std::uint64_t key, std::uint32_t phi, std::uint32_t delta, std::uint64_t work);
+
+    bool outOfBudget();
+    void reportProgress();
+
+    Engine engine_;
+    std::vector<Entry> table_;
+    std::size_t bucketMask_;
+    std::size_t tableUsage_;
+    SearchLimits limits_;
+    ProgressCallback progressCallback_;
+    std::uint64_t progressInterval_;
+    std::uint64_t nextProgress_;
+    std::uint64_t nodes_;
+    std::uint64_t nextClockCheck_;
+    bool stopped_;
+    Clock::time_point start_;
+    Clock::time_point deadline_;
+    Player attacker_;
+    std::uint64_t attackerKey_;
+    // Whether the attacker moves at the root; the root numbers are the mover's
+    bool rootAttacks_;
+    std::uint32_t rootPhi_;
+    std::uint32_t rootDelta_;
+    int provenMove_;
+};
+
+using ProofSolver = BasicProofSolver<ClassicGameEngine>;
+
+// Instantiated in proof_solver.cpp
+extern template class BasicProofSolver<ClassicGameEngine>;
+extern template class BasicProofSolver<GameEngine4x4>;
+extern template class BasicProofSolver<GameEngine5x5>;
+extern template class BasicProofSolver<GameEngine6x6>;
+extern template class BasicProofSolver<GomokuEngine>;
+extern template class BasicProofSolver<QubicEngine>;
+
+} // namespace tictactoe
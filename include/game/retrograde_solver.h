@@ -0,0 +1,92 @@
+#pragma once
+
+#include "basic_game_engine.h"
+#include "tablebase.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tictactoe {
+
+// Game-theoretic value of a position for the side to move. UNKNOWN marks
+// positions no game reaches: stone counts that do not match the side to
+// move, or a line for the side to move.
+enum class Outcome : std::uint8_t {
+    UNKNOWN = 0,
+    WIN = 1,
+    LOSS = 2,
+    DRAW = 3
+};
+
+// The outcome of every position of a board, 2 bits each, indexed by
+// Engine::getPositionIndex(): 3^16 positions of 4x4 fit in about 10.8 MB.
+// Filled by RetrogradeSolver, or mapped from a tablebase file it wrote, in
+// which case pages are only read as lookups reach them.
+template <typename Engine>
+class OutcomeTable {
+public:
+    // Boards of up to 16 cells; above that the table outgrows memory
+    static constexpr bool kAvailable = Engine::kHasPositionIndex && Engine::kCells <= 16;
+    static constexpr std::uint64_t kPositions = kAvailable ? PositionIndex<Engine::kCells>::kPowers[Engine::kCells - 1] * 3 : 0;
+    static constexpr int kPerWord = 32;
+
+    OutcomeTable() = default;
+    explicit OutcomeTable(std::vector<std::uint64_t> words);
+
+    // False until solved or loaded
+    bool isLoaded() const;
+    // True if the outcomes are read from a mapped file
+    bool isMapped() const;
+
+    Outcome get(std::uint64_t positionIndex) const;
+    Outcome lookup(const Engine& engine) const;
+
+    // Best cell for the side to move by the table: a move that wins at
+    // once, else one into a lost position for the opponent, else one into
+    // a draw, walking `order` for ties. -1 if the game is over, the
+    // position is not in the table, or every move loses.
+    int bestMove(Engine& engine, const std::array<int, Engine::kCells>& order) const;
+
+    // Positions with each outcome, indexed by Outcome
+    std::vector<std::uint64_t> countOutcomes() const;
+
+    // Tablebase file of 2-bit entries by position rank. load() opens it
+    // with Tablebase (header checks only), refuses a file built for another
+    // board and leaves the table empty on failure.
+    bool save(const std::string& path) const;
+    bool load(const std::string& path, Tablebase::Verify verify = Tablebase::Verify::HEADER);
+
+    static TablebaseInfo describe();
+
+private:
+    const std::uint64_t* words() const;
+
+    // Solved in this process, or the mapped file
+    std::vector<std::uint64_t> owned_;
+    std::shared_ptr<const Tablebase> tablebase_;
+};
+
+// Solves every position of a small board by retrograde analysis: positions
+// are valued from the full board back to the empty one, a stone count at a
+// time, each from the outcomes of its children one level up. The positions
+// of one level are independent, so each level is shared out between
+// threads; they write their 2-bit results into shared words with atomic ORs.
+template <typename Engine>
+class RetrogradeSolver {
+public:
+    static_assert(OutcomeTable<Engine>::kAvailable, "retrograde tables cover boards of up to 16 cells");
+
+    // threadCount 0 means one per hardware thread
+    static OutcomeTable<Engine> solve(unsigned threadCount = 0);
+};
+
+// Instantiated in retrograde_solver.cpp
+extern template class OutcomeTable<ClassicGameEngine>;
+extern template class OutcomeTable<GameEngine4x4>;
+extern template class RetrogradeSolver<ClassicGameEngine>;
+extern template class RetrogradeSolver<GameEngine4x4>;
+
+} // namespace tictactoe
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "bitmask.h"
+#include "zobrist.h"
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace tictactoe {
+
+// The 8 symmetries of a square board (the dihedral group D4)
+enum class Transform : std::uint8_t {
+    IDENTITY,
+    ROTATE_90,      // clockwise
+    ROTATE_180,
+    ROTATE_270,
+    MIRROR,         // left <-> right
+    FLIP,           // top <-> bottom
+    TRANSPOSE,      // main diagonal
+    ANTI_TRANSPOSE  // anti-diagonal
+};
+
+namespace detail {
+
+// Image of every cell under every transform
+template <int N>
+constexpr std::array<std::array<std::uint8_t, N * N>, 8> makeCellMaps()
+{
+    constexpr int n = N - 1;
+    std::array<std::array<std::uint8_t, N * N>, 8> maps{};
+    for (int row = 0; row < N; ++row) {
+        for (int col = 0; col < N; ++col) {
+            const int images[8][2] = {
+                {row, col},
+                {col, n - row},
+                {n - row, n - col},
+                {n - col, row},
+                {row, n - col},
+                {n - row, col},
+                {col, row},
+                {n - col, n - row}
+            };
+            for (int t = 0; t < 8; ++t) {
+                maps[t][row * N + col] = static_cast<std::uint8_t>(images[t][0] * N + images[t][1]);
+            }
+        }
+    }
+    return maps;
+}
+
+template <int N>
+constexpr std::array<std::uint8_t, 8> makeInverses()
+{
+    constexpr auto maps = makeCellMaps<N>();
+    std::array<std::uint8_t, 8> inverses{};
+    for (int t = 0; t < 8; ++t) {
+        for (int u = 0; u < 8; ++u) {
+            bool undoes = true;
+            for (int cell = 0; cell < N * N; ++cell) {
+                if (maps[u][maps[t][cell]] != cell) {
+                    undoes = false;
+                    break;
+                }
+            }
+            if (undoes) {
+                inverses[t] = static_cast<std::uint8_t>(u);
+                break;
+            }
+        }
+    }
+    return inverses;
+}
+
+// For integer masks: kTables[t][chunk][byte] is the image of `byte` placed
+// at bit 8 * chunk, so a transform is one lookup per byte of the mask
+template <int N>
+struct ByteTables {
+    static constexpr int kChunks = (N * N + 7) / 8;
+    std::array<std::array<std::array<CellMask<N * N>, 256>, kChunks>, 8> tables{};
+};
+
+template <int N>
+constexpr ByteTables<N> makeByteTables()
+{
+    using Mask = CellMask<N * N>;
+    constexpr auto maps = makeCellMaps<N>();
+
+    ByteTables<N> result{};
+    for (int t = 0; t < 8; ++t) {
+        for (int chunk = 0; chunk < ByteTables<N>::kChunks; ++chunk) {
+            for (int byte = 0; byte < 256; ++byte) {
+                Mask image = 0;
+                for (int bit = 0; bit < 8; ++bit) {
+                    const int cell = chunk * 8 + bit;
+                    if (cell < N * N && ((byte >> bit) & 1) != 0) {
+                        image |= maskOf<Mask>(maps[t][cell]);
+                    }
+                }
+                result.tables[t][chunk][byte] = image;
+            }
+        }
+    }
+    return result;
+}
+
+template <typename Mask>
+constexpr bool maskLess(const Mask& lhs, const Mask& rhs)
+{
+    if constexpr (std::is_integral_v<Mask>) {
+        return lhs < rhs;
+    } else {
+        for (std::size_t i = lhs.words.size(); i-- > 0;) {
+            if (lhs.words[i] != rhs.words[i]) {
+                return lhs.words[i] < rhs.words[i];
+            }
+        }
+        return false;
+    }
+}
+
+} // namespace detail
+
+// Symmetry operations on packed N x N boards (one mask per player)
+template <int N>
+struct Symmetry {
+    using Mask = CellMask<N * N>;
+
+    struct Canonical {
+        Mask xMask;
+        Mask oMask;
+        Transform transform;   // canonical = apply(transform, original)
+    };
+
+    static constexpr std::array<std::array<std::uint8_t, N * N>, 8> kCellMaps = detail::makeCellMaps<N>();
+    static constexpr std::array<std::uint8_t, 8> kInverses = detail::makeInverses<N>();
+
+    static Transform inverse(Transform transform)
+    {
+        return static_cast<Transform>(kInverses[static_cast<int>(transform)]);
+    }
+
+    static int mapCell(Transform transform, int cell)
+    {
+        return kCellMaps[static_cast<int>(transform)][cell];
+    }
+
+    // Cell of the original board that `transform` moved to `cell`
+    static int unmapCell(Transform transform, int cell)
+    {
+        return kCellMaps[kInverses[static_cast<int>(transform)]][cell];
+    }
+
+    static Mask apply(Transform transform, const Mask& mask);
+
+    // Smallest (X mask, O mask) image among the 8 transforms
+    static Canonical canonicalize(const Mask& xMask, const Mask& oMask);
+
+    // Base-3 position index of the canonical form; boards up to 40 cells
+    static std::uint64_t canonicalIndex(const Mask& xMask, const Mask& oMask);
+};
+
+template <int N>
+typename Symmetry<N>::Mask Symmetry<N>::apply(Transform transform, const Mask& mask)
+{
+    const int t = static_cast<int>(transform);
+    if constexpr (std::is_integral_v<Mask>) {
+        static constexpr detail::ByteTables<N> kTables = detail::makeByteTables<N>();
+        Mask image = 0;
+        for (int chunk = 0; chunk < detail::ByteTables<N>::kChunks; ++chunk) {
+            image |= kTables.tables[t][chunk][(mask >> (8 * chunk)) & 0xFF];
+        }
+        return image;
+    } else {
+        Mask image{};
+        Mask remaining = mask;
+        while (!isEmptyMask(remaining)) {
+            image |= maskOf<Mask>(kCellMaps[t][popLowestCell(remaining)]);
+        }
+        return image;
+    }
+}
+
+template <int N>
+typename Symmetry<N>::Canonical Symmetry<N>::canonicalize(const Mask& xMask, const Mask& oMask)
+{
+    Canonical best{xMask, oMask, Transform::IDENTITY};
+    for (int t = 1; t < 8; ++t) {
+        const auto transform = static_cast<Transform>(t);
+        const Mask x = apply(transform, xMask);
+        if (detail::maskLess(best.xMask, x)) {
+            continue;
+        }
+        const Mask o = apply(transform, oMask);
+        if (detail::maskLess(x, best.xMask) || detail::maskLess(o, best.oMask)) {
+            best = Canonical{x, o, transform};
+        }
+    }
+    return best;
+}
+
+template <int N>
+std::uint64_t Symmetry<N>::canonicalIndex(const Mask& xMask, const Mask& oMask)
+{
+    static_assert(PositionIndex<N * N>::kAvailable, "3^cells does not fit in 64 bits");
+
+    const Canonical canonical = canonicalize(xMask, oMask);
+    std::uint64_t index = 0;
+    for (int cell = 0; cell < N * N; ++cell) {
+        if (hasCell(canonical.xMask, cell)) {
+            index += PositionIndex<N * N>::kPowers[cell];
+        } else if (hasCell(canonical.oMask, cell)) {
+            index += 2 * PositionIndex<N * N>::kPowers[cell];
+        }
+    }
+    return index;
+}
+
+} // namespace tictactoe
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tictactoe {
+
+// How a tablebase turns a position into an entry number
+enum class TablebaseIndex : std::uint32_t {
+    POSITION_RANK = 0   // getPositionIndex(): base-3 rank of the cells
+};
+
+// The board a tablebase was built for and the shape of its entries
+struct TablebaseInfo {
+    std::uint32_t cells = 0;
+    std::uint32_t winLength = 0;
+    std::uint32_t dimensions = 0;
+    std::uint32_t bitsPerEntry = 0;
+    TablebaseIndex index = TablebaseIndex::POSITION_RANK;
+    std::uint64_t entries = 0;
+};
+
+enum class TablebaseError {
+    NONE,
+    OPEN_FAILED,          // missing or unreadable file
+    BAD_MAGIC,            // not a tablebase
+    BAD_VERSION,          // written by a newer format version
+    WRONG_BYTE_ORDER,     // written on a host of the other byte order
+    BAD_HEADER,           // header checksum or fields do not add up
+    SIZE_MISMATCH,        // file shorter or longer than its header says
+    BAD_CHECKSUM          // payload does not match its checksum
+};
+
+// Read-only view of a solved-position file. The file is a 64-byte header
+// (magic, format version, byte-order mark, the TablebaseInfo, the payload
+// size and checksums of header and payload) and then the entries, packed
+// into 64-bit words.
+//
+// open() maps the file instead of reading it: pages are read from disk the
+// first time a lookup touches them, so opening costs the same for any size,
+// and every process mapping the same file shares one copy in the page
+// cache. Where mapping is not available the payload is read into memory.
+//
+// By default open() checks only the header; the payload checksum needs
+// every page, so it is checked by verify() or an open with Verify::FULL.
+class Tablebase {
+public:
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr std::size_t kHeaderBytes = 64;
+
+    enum class Verify {
+        HEADER,
+        FULL
+    };
+
+    Tablebase() = default;
+    ~Tablebase();
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    // Closes any file already open; on failure getError() says why
+    bool open(const std::string& path, Verify verify = Verify::HEADER);
+    void close();
+
+    bool isOpen() const;
+    // True if the payload is mapped rather than copied into memory
+    bool isMapped() const;
+    TablebaseError getError() const;
+    const TablebaseInfo& getInfo() const;
+
+    const std::uint64_t* getWords() const;
+    std::size_t getWordCount() const;
+
+    // Recompute the payload checksum; touches every page
+    bool verify() const;
+
+    static bool write(const std::string& path, const TablebaseInfo& info,
+                      const std::uint64_t* words, std::size_t wordCount);
+
+    static const char* describeError(TablebaseError error);
+
+private:
+    bool fail(TablebaseError error);
+
+    TablebaseInfo info_;
+    TablebaseError error_ = TablebaseError::NONE;
+    std::uint64_t payloadChecksum_ = 0;
+
+    // The whole file when mapped, with the words kHeaderBytes in
+    void* mapping_ = nullptr;
+    std::size_t mappingBytes_ = 0;
+    // The payload when it had to be read instead
+    std::vector<std::uint64_t> copy_;
+
+    const std::uint64_t* words_ = nullptr;
+    std::size_t wordCount_ = 0;
+};
+
+} // namespace tictactoe
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace tictactoe {
+
+// What a stored score says about the true value of the position
+enum class Bound : std::uint8_t {
+    NONE,
+    EXACT,
+    LOWER,   // true value >= score (search failed high)
+    UPPER    // true value <= score (search failed low)
+};
+
+struct TTEntry {
+    std::uint64_t key = 0;
+    std::int16_t score = 0;
+    std::int16_t move = -1;
+    std::uint8_t depth = 0;
+    Bound bound = Bound::NONE;
+    std::uint8_t generation = 0;
+};
+
+// Fixed-size hash table of search results keyed by a 64-bit position hash.
+// Entries live in 64-byte buckets of 4 so a probe touches one cache line.
+// The table keeps its contents across searches; newSearch() ages old
+// entries so they are replaced first.
+//
+// probe() and store() may run concurrently from several search threads
+// without locks. Each slot holds the packed entry and the key XOR the
+// packed entry; a slot torn by two racing writers fails that check and
+// reads as empty. newSearch(), clear() and resize() must not overlap a
+// search.
+class TranspositionTable {
+public:
+    enum class Replacement {
+        ALWAYS,           // a new result always evicts the weakest slot
+        DEPTH_PREFERRED   // keep deeper results from the current search
+    };
+
+    static constexpr std::size_t kDefaultCapacity = std::size_t(1) << 16;
+
+    // capacity is a number of entries, rounded up to whole buckets of a
+    // power-of-two count
+    explicit TranspositionTable(std::size_t capacity = kDefaultCapacity,
+                                Replacement replacement = Replacement::DEPTH_PREFERRED);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    bool probe(std::uint64_t key, TTEntry& entry) const;
+    void store(std::uint64_t key, int score, int move, int depth, Bound bound);
+
+    void newSearch();
+    void clear();
+    void resize(std::size_t capacity);
+
+    std::size_t getCapacity() const;
+    Replacement getReplacement() const;
+    void setReplacement(Replacement replacement);
+
+    // Number of occupied slots
+    std::size_t getUsage() const;
+
+private:
+    static constexpr int kBucketSize = 4;
+
+    struct Slot {
+        std::atomic<std::uint64_t> check{0};   // key ^ data
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[kBucketSize];
+    };
+
+    static std::uint64_t pack(const TTEntry& entry);
+    static TTEntry unpack(std::uint64_t key, std::uint64_t data);
+
+    Bucket& bucketFor(std::uint64_t key);
+    const Bucket& bucketFor(std::uint64_t key) const;
+
+    std::unique_ptr<Bucket[]> buckets_;
+    std::size_t bucketCount_;
+    std::uint64_t bucketMask_;
+    Replacement replacement_;
+    std::uint8_t generation_;
+};
+
+} // namespace tictactoe
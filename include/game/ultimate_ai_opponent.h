@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ultimate_game_engine.h"
+#include "ai_opponent.h"
+#include "transposition_table.h"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace tictactoe {
+
+// Alpha-beta player for Ultimate Tic-Tac-Toe: negamax with a transposition
+// table and iterative deepening, on one engine with make/undo. The game is
+// far too large to solve, so the search is always bounded; it scores the
+// horizon by the lines still open on the sub-boards and on the meta board.
+class UltimateAIOpponent {
+public:
+    using StatsCallback = std::function<void(const SearchStats&)>;
+
+    // Think time when the search limits set neither a time nor a node budget
+    static constexpr std::chrono::milliseconds kDefaultMoveTime{1000};
+
+    explicit UltimateAIOpponent(std::size_t tableCapacity = TranspositionTable::kDefaultCapacity);
+
+    UltimateAIOpponent(const UltimateAIOpponent&) = delete;
+    UltimateAIOpponent& operator=(const UltimateAIOpponent&) = delete;
+
+    // Best cell for the side to move, or -1 if the game is over
+    int calculateBestMove(const UltimateGameEngine& engine);
+
+    // Static score for the side to move, between -10000 and 10000
+    static int evaluatePosition(const UltimateGameEngine& engine);
+
+    TranspositionTable& getTranspositionTable();
+
+    void setSearchLimits(const SearchLimits& limits);
+    const SearchLimits& getSearchLimits() const;
+
+    // Counters of the last search; all zero if the game was already over
+    const SearchStats& getSearchStats() const;
+
+    // Called after every search with its stats; an empty callback turns
+    // it off
+    void setStatsCallback(StatsCallback callback);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Moves = std::array<int, UltimateGameEngine::kCells>;
+
+    // Legal moves of engine_ into `moves`, best guess first; returns the
+    // count
+    int orderMoves(int tableMove, Moves& moves) const;
+
+    // Score of engine_ for the side to move, searched `depth` plies deep;
+    // ply counts moves from the root
+    int negamax(int ply, int depth, int alpha, int beta);
+
+    bool outOfBudget();
+
+    UltimateGameEngine engine_;
+    TranspositionTable table_;
+    SearchLimits limits_;
+    Clock::time_point deadline_;
+    std::uint64_t nextClockCheck_;
+    bool stopped_;
+    SearchStats stats_;
+    StatsCallback statsCallback_;
+};
+
+} // namespace tictactoe
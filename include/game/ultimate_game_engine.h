@@ -0,0 +1,341 @@
+#pragma once
+
+#include "basic_game_engine.h"
+#include <array>
+#include <cstdint>
+
+namespace tictactoe {
+
+namespace detail {
+
+// Bit m set for every 9-bit sub-board mask m that holds a 3x3 line
+constexpr std::array<std::uint64_t, 8> makeSubBoardLineTable()
+{
+    std::array<std::uint64_t, 8> table{};
+    for (int squares = 0; squares < 512; ++squares) {
+        for (const auto line : ClassicGameEngine::Lines::kMasks) {
+            if ((squares & line) == line) {
+                table[squares >> 6] |= std::uint64_t{1} << (squares & 63);
+                break;
+            }
+        }
+    }
+    return table;
+}
+
+template <int Count>
+constexpr std::array<std::uint64_t, Count> makeForcedBoardKeys()
+{
+    std::array<std::uint64_t, Count> keys{};
+    for (int i = 0; i < Count; ++i) {
+        keys[i] = splitMix64(0x0F0F0000u + static_cast<std::uint64_t>(i));
+    }
+    return keys;
+}
+
+} // namespace detail
+
+// Ultimate Tic-Tac-Toe: a 3x3 grid of 3x3 boards. A move's square within
+// its sub-board picks the sub-board the opponent must play in next, unless
+// that one is already won or full, which frees the choice. Winning a
+// sub-board claims its square of the meta board; three claimed in a line
+// win the game, and the game is drawn once every sub-board is closed.
+//
+// The state is nine 9-bit masks per player plus 9-bit meta masks for the
+// sub-boards each side has won and for those closed, so legal moves and
+// sub-board wins come from a few bit operations. Cells are numbered
+// board * 9 + square, both row-major from the top left; rowOf() and colOf()
+// map them onto the 9 x 9 grid the player sees.
+class UltimateGameEngine {
+public:
+    static constexpr int kSize = 9;
+    static constexpr int kCells = 81;
+    static constexpr int kBoards = 9;
+    static constexpr int kAnyBoard = -1;
+
+    // One bit per square of a sub-board, or per sub-board of the meta board
+    using SubMask = std::uint16_t;
+    using Mask = CellMask<kCells>;
+    using Board = std::array<std::array<Player, kSize>, kSize>;
+    using Zobrist = ZobristKeys<kCells>;
+
+    static constexpr SubMask kFullSubBoard = 0x1FF;
+
+    UltimateGameEngine();
+
+    // Game control
+    bool makeMove(int row, int col);
+    bool makeMove(int cell);
+    bool undoMove();
+    void resetGame();
+
+    // Game state
+    GameState getGameState() const;
+    Player getCurrentPlayer() const;
+    Board getBoard() const;
+    Player getCell(int cell) const;
+    bool isGameOver() const;
+    bool isValidMove(int row, int col) const;
+    int getMoveCount() const;
+    int getLastMove() const;
+
+    // Sub-board the next move must go to, or kAnyBoard
+    int getForcedBoard() const;
+    // Sub-boards the next move may go to; empty once the game is over
+    SubMask getPlayableBoards() const;
+    // Empty squares of one sub-board
+    SubMask getEmptySquares(int board) const;
+    SubMask getSquares(int board, Player player) const;
+    // Meta board: sub-boards won by `player`, and those won or full
+    SubMask getWonBoards(Player player) const;
+    SubMask getClosedBoards() const;
+
+    // Every legal cell as one 81-bit mask; the search walks
+    // getPlayableBoards() and getEmptySquares() instead
+    Mask getLegalMoves() const;
+
+    // Covers the stones, the side to move and the forced sub-board
+    std::uint64_t getZobristKey() const;
+
+    static constexpr int cellOf(int board, int square) { return board * 9 + square; }
+    static constexpr int rowOf(int cell) { return (cell / 27) * 3 + (cell % 9) / 3; }
+    static constexpr int colOf(int cell) { return ((cell / 9) % 3) * 3 + cell % 3; }
+    static constexpr int cellAt(int row, int col) { return cellOf((row / 3) * 3 + col / 3, (row % 3) * 3 + col % 3); }
+
+    // True if the squares hold a row, column or diagonal
+    static bool hasLine(SubMask squares);
+
+private:
+    static constexpr std::array<std::uint64_t, 8> kLineTable = detail::makeSubBoardLineTable();
+    // One key per forced sub-board, kAnyBoard first
+    static constexpr std::array<std::uint64_t, kBoards + 1> kForcedBoardKeys = detail::makeForcedBoardKeys<kBoards + 1>();
+
+    // Where the move after one on `square` must go
+    int nextBoard(int square) const;
+
+    std::array<std::array<SubMask, kBoards>, 2> squares_;
+    std::array<SubMask, 2> won_;
+    SubMask closed_;
+    Player currentPlayer_;
+    GameState gameState_;
+    int forcedBoard_;
+    int moveCount_;
+    std::uint64_t zobristKey_;
+    std::array<std::uint8_t, kCells> moves_;
+};
+
+inline UltimateGameEngine::UltimateGameEngine()
+{
+    resetGame();
+}
+
+inline bool UltimateGameEngine::makeMove(int row, int col)
+{
+    if (row < 0 || row >= kSize || col < 0 || col >= kSize) {
+        return false;
+    }
+    return makeMove(cellAt(row, col));
+}
+
+inline bool UltimateGameEngine::makeMove(int cell)
+{
+    if (cell < 0 || cell >= kCells) {
+        return false;
+    }
+    const int board = cell / 9;
+    const int square = cell % 9;
+    if (((getPlayableBoards() >> board) & 1u) == 0 || ((getEmptySquares(board) >> square) & 1u) == 0) {
+        return false;
+    }
+
+    const int side = (currentPlayer_ == Player::X) ? 0 : 1;
+    SubMask& own = squares_[side][board];
+    own = static_cast<SubMask>(own | (1u << square));
+    zobristKey_ ^= Zobrist::kPieces[cell][side];
+    moves_[moveCount_++] = static_cast<std::uint8_t>(cell);
+
+    // Only the mover's sub-board can have changed hands, and only then
+    // can the meta board have a new line
+    if (hasLine(own)) {
+        won_[side] = static_cast<SubMask>(won_[side] | (1u << board));
+        closed_ = static_cast<SubMask>(closed_ | (1u << board));
+        if (hasLine(won_[side])) {
+            gameState_ = (side == 0) ? GameState::X_WON : GameState::O_WON;
+        }
+    } else if ((squares_[0][board] | squares_[1][board]) == kFullSubBoard) {
+        closed_ = static_cast<SubMask>(closed_ | (1u << board));
+    }
+    if (gameState_ == GameState::IN_PROGRESS && closed_ == kFullSubBoard) {
+        gameState_ = GameState::DRAW;
+    }
+
+    forcedBoard_ = nextBoard(square);
+    if (gameState_ == GameState::IN_PROGRESS) {
+        currentPlayer_ = (currentPlayer_ == Player::X) ? Player::O : Player::X;
+        zobristKey_ ^= Zobrist::kOToMove;
+    }
+    return true;
+}
+
+inline bool UltimateGameEngine::undoMove()
+{
+    if (moveCount_ == 0) {
+        return false;
+    }
+
+    const int cell = moves_[--moveCount_];
+    const int board = cell / 9;
+    const int side = ((squares_[0][board] >> (cell % 9)) & 1u) ? 0 : 1;
+    const Player mover = (side == 0) ? Player::X : Player::O;
+
+    // The move went into an open sub-board, so undoing it reopens it
+    squares_[side][board] = static_cast<SubMask>(squares_[side][board] & ~(1u << (cell % 9)));
+    won_[side] = static_cast<SubMask>(won_[side] & ~(1u << board));
+    closed_ = static_cast<SubMask>(closed_ & ~(1u << board));
+    zobristKey_ ^= Zobrist::kPieces[cell][side];
+
+    if (currentPlayer_ != mover) {
+        zobristKey_ ^= Zobrist::kOToMove;
+    }
+    currentPlayer_ = mover;
+    gameState_ = GameState::IN_PROGRESS;
+    forcedBoard_ = (moveCount_ > 0) ? nextBoard(moves_[moveCount_ - 1] % 9) : kAnyBoard;
+    return true;
+}
+
+inline void UltimateGameEngine::resetGame()
+{
+    for (auto& boards : squares_) {
+        boards.fill(0);
+    }
+    won_ = {0, 0};
+    closed_ = 0;
+    currentPlayer_ = Player::X;
+    gameState_ = GameState::IN_PROGRESS;
+    forcedBoard_ = kAnyBoard;
+    moveCount_ = 0;
+    zobristKey_ = 0;
+}
+
+inline GameState UltimateGameEngine::getGameState() const
+{
+    return gameState_;
+}
+
+inline Player UltimateGameEngine::getCurrentPlayer() const
+{
+    return currentPlayer_;
+}
+
+inline UltimateGameEngine::Board UltimateGameEngine::getBoard() const
+{
+    Board board;
+    for (int row = 0; row < kSize; ++row) {
+        for (int col = 0; col < kSize; ++col) {
+            board[row][col] = getCell(cellAt(row, col));
+        }
+    }
+    return board;
+}
+
+inline Player UltimateGameEngine::getCell(int cell) const
+{
+    const int board = cell / 9;
+    const int square = cell % 9;
+    if ((squares_[0][board] >> square) & 1u) {
+        return Player::X;
+    }
+    if ((squares_[1][board] >> square) & 1u) {
+        return Player::O;
+    }
+    return Player::NONE;
+}
+
+inline bool UltimateGameEngine::isGameOver() const
+{
+    return gameState_ != GameState::IN_PROGRESS;
+}
+
+inline bool UltimateGameEngine::isValidMove(int row, int col) const
+{
+    if (row < 0 || row >= kSize || col < 0 || col >= kSize) {
+        return false;
+    }
+    const int cell = cellAt(row, col);
+    return ((getPlayableBoards() >> (cell / 9)) & 1u) != 0 && ((getEmptySquares(cell / 9) >> (cell % 9)) & 1u) != 0;
+}
+
+inline int UltimateGameEngine::getMoveCount() const
+{
+    return moveCount_;
+}
+
+inline int UltimateGameEngine::getLastMove() const
+{
+    return moveCount_ > 0 ? moves_[moveCount_ - 1] : -1;
+}
+
+inline int UltimateGameEngine::getForcedBoard() const
+{
+    return forcedBoard_;
+}
+
+inline UltimateGameEngine::SubMask UltimateGameEngine::getPlayableBoards() const
+{
+    if (gameState_ != GameState::IN_PROGRESS) {
+        return 0;
+    }
+    if (forcedBoard_ != kAnyBoard) {
+        return static_cast<SubMask>(1u << forcedBoard_);
+    }
+    return static_cast<SubMask>(kFullSubBoard & ~closed_);
+}
+
+inline UltimateGameEngine::SubMask UltimateGameEngine::getEmptySquares(int board) const
+{
+    return static_cast<SubMask>(kFullSubBoard & ~(squares_[0][board] | squares_[1][board]));
+}
+
+inline UltimateGameEngine::SubMask UltimateGameEngine::getSquares(int board, Player player) const
+{
+    return squares_[player == Player::X ? 0 : 1][board];
+}
+
+inline UltimateGameEngine::SubMask UltimateGameEngine::getWonBoards(Player player) const
+{
+    return won_[player == Player::X ? 0 : 1];
+}
+
+inline UltimateGameEngine::SubMask UltimateGameEngine::getClosedBoards() const
+{
+    return closed_;
+}
+
+inline UltimateGameEngine::Mask UltimateGameEngine::getLegalMoves() const
+{
+    Mask legal{};
+    for (SubMask boards = getPlayableBoards(); boards != 0; boards = static_cast<SubMask>(boards & (boards - 1))) {
+        const int board = lowestBit64(boards);
+        for (SubMask empty = getEmptySquares(board); empty != 0; empty = static_cast<SubMask>(empty & (empty - 1))) {
+            legal |= maskOf<Mask>(cellOf(board, lowestBit64(empty)));
+        }
+    }
+    return legal;
+}
+
+inline std::uint64_t UltimateGameEngine::getZobristKey() const
+{
+    return zobristKey_ ^ kForcedBoardKeys[forcedBoard_ + 1];
+}
+
+inline bool UltimateGameEngine::hasLine(SubMask squares)
+{
+    return ((kLineTable[squares >> 6] >> (squares & 63)) & 1u) != 0;
+}
+
+inline int UltimateGameEngine::nextBoard(int square) const
+{
+    return ((closed_ >> square) & 1u) ? kAnyBoard : square;
+}
+
+} // namespace tictactoe
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "bitmask.h"
+#include <array>
+#include <cstdint>
+
+namespace tictactoe {
+
+namespace detail {
+
+constexpr int cellCountOf(int n, int dimensions)
+{
+    int cells = 1;
+    for (int axis = 0; axis < dimensions; ++axis) {
+        cells *= n;
+    }
+    return cells;
+}
+
+// Line directions in D dimensions: every step of -1, 0 or 1 per axis whose
+// first non-zero step is +1, so each line is found once. Coordinates run
+// from the slowest axis to the fastest (layer, row, col). In 2D the order
+// is rows, columns, diagonals, anti-diagonals.
+template <int D>
+constexpr int directionCount()
+{
+    return (cellCountOf(3, D) - 1) / 2;
+}
+
+template <int D>
+constexpr std::array<std::array<int, D>, directionCount<D>()> makeDirections()
+{
+    std::array<std::array<int, D>, directionCount<D>()> directions{};
+    int index = 0;
+    for (int lead = D - 1; lead >= 0; --lead) {
+        // Steps after the leading axis in the order 0, +1, -1, the
+        // earliest axis changing slowest
+        const int tail = D - 1 - lead;
+        for (int code = 0; code < cellCountOf(3, tail); ++code) {
+            auto& direction = directions[index++];
+            direction[lead] = 1;
+            int rest = code;
+            for (int axis = D - 1; axis > lead; --axis, rest /= 3) {
+                direction[axis] = (rest % 3 == 2) ? -1 : rest % 3;
+            }
+        }
+    }
+    return directions;
+}
+
+template <int N, int K, int D>
+constexpr int winLineCount()
+{
+    int count = 0;
+    for (const auto& direction : makeDirections<D>()) {
+        int starts = 1;
+        for (const int step : direction) {
+            starts *= (step == 0) ? N : N - K + 1;
+        }
+        count += starts;
+    }
+    return count;
+}
+
+// Every K-in-a-row segment on an N^D board, direction by direction and
+// within a direction by starting cell. Cells are numbered with the last
+// coordinate fastest: row * N + col in 2D.
+template <int N, int K, int D>
+constexpr std::array<std::array<std::uint8_t, K>, winLineCount<N, K, D>()> makeWinLineCells()
+{
+    constexpr int kCells = cellCountOf(N, D);
+    constexpr auto kDirections = makeDirections<D>();
+
+    std::array<std::array<std::uint8_t, K>, winLineCount<N, K, D>()> lines{};
+    int index = 0;
+    for (const auto& direction : kDirections) {
+        for (int start = 0; start < kCells; ++start) {
+            // Coordinates of the start cell, slowest axis first
+            std::array<int, D> coords{};
+            for (int axis = D - 1, rest = start; axis >= 0; --axis, rest /= N) {
+                coords[axis] = rest % N;
+            }
+
+            bool fits = true;
+            for (int axis = 0; axis < D; ++axis) {
+                const int end = coords[axis] + direction[axis] * (K - 1);
+                fits = fits && end >= 0 && end < N;
+            }
+            if (!fits) {
+                continue;
+            }
+
+            int step = 0;
+            for (int axis = 0; axis < D; ++axis) {
+                step = step * N + direction[axis];
+            }
+            for (int i = 0; i < K; ++i) {
+                lines[index][i] = static_cast<std::uint8_t>(start + step * i);
+            }
+            ++index;
+        }
+    }
+    return lines;
+}
+
+template <int N, int K, int D>
+constexpr std::array<CellMask<cellCountOf(N, D)>, winLineCount<N, K, D>()> makeWinLineMasks()
+{
+    constexpr auto cells = makeWinLineCells<N, K, D>();
+
+    std::array<CellMask<cellCountOf(N, D)>, winLineCount<N, K, D>()> masks{};
+    for (int line = 0; line < winLineCount<N, K, D>(); ++line) {
+        for (int i = 0; i < K; ++i) {
+            masks[line] |= maskOf<CellMask<cellCountOf(N, D)>>(cells[line][i]);
+        }
+    }
+    return masks;
+}
+
+// Maximum number of K-lines through one cell: K per direction
+template <int K, int D>
+constexpr int maxLinesPerCell()
+{
+    return directionCount<D>() * K;
+}
+
+// For every cell, the indices of the win lines passing through it
+template <int N, int K, int D>
+struct CellLineTable {
+    std::array<std::array<std::uint16_t, maxLinesPerCell<K, D>()>, cellCountOf(N, D)> lines{};
+    std::array<std::uint8_t, cellCountOf(N, D)> counts{};
+};
+
+template <int N, int K, int D>
+constexpr CellLineTable<N, K, D> makeCellLineTable()
+{
+    constexpr auto cells = makeWinLineCells<N, K, D>();
+
+    CellLineTable<N, K, D> table{};
+    for (int line = 0; line < winLineCount<N, K, D>(); ++line) {
+        for (int i = 0; i < K; ++i) {
+            const int cell = cells[line][i];
+            table.lines[cell][table.counts[cell]] = static_cast<std::uint16_t>(line);
+            ++table.counts[cell];
+        }
+    }
+    return table;
+}
+
+} // namespace detail
+
+// Compile-time table of all winning lines for K-in-a-row on a board N cells
+// wide in each of D dimensions: N x N by default, N x N x N for D = 3
+template <int N, int K, int D = 2>
+struct WinLines {
+    static_assert(K >= 1 && K <= N, "win length must fit on the board");
+    static_assert(D == 2 || D == 3, "boards are flat or cubes");
+    static_assert(detail::cellCountOf(N, D) <= 256, "cell indices are stored as bytes");
+
+    using Mask = CellMask<detail::cellCountOf(N, D)>;
+
+    static constexpr int kCount = detail::winLineCount<N, K, D>();
+    static constexpr std::array<std::array<std::uint8_t, K>, kCount> kCells = detail::makeWinLineCells<N, K, D>();
+    static constexpr std::array<Mask, kCount> kMasks = detail::makeWinLineMasks<N, K, D>();
+
+    // Lines through each cell, so a move only has to touch its own lines
+    static constexpr detail::CellLineTable<N, K, D> kByCell = detail::makeCellLineTable<N, K, D>();
+};
+
+} // namespace tictactoe
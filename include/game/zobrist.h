@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace tictactoe {
+
+namespace detail {
+
+constexpr std::uint64_t splitMix64(std::uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+template <int Cells>
+constexpr std::array<std::array<std::uint64_t, 2>, Cells> makeZobristPieceKeys()
+{
+    std::array<std::array<std::uint64_t, 2>, Cells> keys{};
+    for (int cell = 0; cell < Cells; ++cell) {
+        keys[cell][0] = splitMix64(static_cast<std::uint64_t>(2 * cell + 1));
+        keys[cell][1] = splitMix64(static_cast<std::uint64_t>(2 * cell + 2));
+    }
+    return keys;
+}
+
+template <int Cells>
+constexpr std::array<std::uint64_t, Cells> makePowersOfThree()
+{
+    std::array<std::uint64_t, Cells> powers{};
+    std::uint64_t power = 1;
+    for (int cell = 0; cell < Cells; ++cell) {
+        powers[cell] = power;
+        power *= 3;
+    }
+    return powers;
+}
+
+} // namespace detail
+
+// Compile-time Zobrist keys: one per (cell, side), plus one for O to move.
+// The same table is used for every board with the same cell count, so keys
+// are stable across builds.
+template <int Cells>
+struct ZobristKeys {
+    static constexpr std::array<std::array<std::uint64_t, 2>, Cells> kPieces = detail::makeZobristPieceKeys<Cells>();
+    static constexpr std::uint64_t kOToMove = detail::splitMix64(0);
+};
+
+// Base-3 position rank: cell i contributes 3^i times 0 (empty), 1 (X) or
+// 2 (O). Exact and collision-free while 3^Cells fits in 64 bits.
+template <int Cells>
+struct PositionIndex {
+    static constexpr bool kAvailable = Cells <= 40;
+    static constexpr std::array<std::uint64_t, Cells> kPowers = detail::makePowersOfThree<Cells>();
+};
+
+} // namespace tictactoe
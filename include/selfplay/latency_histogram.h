@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace tictactoe {
+
+// Log-linear histogram of durations in nanoseconds. Each power of two is
+// split into 8 buckets, so percentiles are accurate to about 12% while
+// the histogram stays a few KB and merges by addition.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(std::uint64_t nanoseconds);
+    void merge(const LatencyHistogram& other);
+
+    std::uint64_t getCount() const;
+    std::uint64_t getMax() const;
+    double getMean() const;
+
+    // Upper bound of the bucket holding the given percentile (0-100)
+    std::uint64_t percentile(double percent) const;
+
+private:
+    static constexpr int kSubBuckets = 8;
+    static constexpr int kBucketCount = 64 * kSubBuckets;
+
+    static int bucketFor(std::uint64_t nanoseconds);
+    static std::uint64_t bucketUpperBound(int bucket);
+
+    std::array<std::uint64_t, kBucketCount> buckets_;
+    std::uint64_t count_;
+    std::uint64_t total_;
+    std::uint64_t max_;
+};
+
+} // namespace tictactoe
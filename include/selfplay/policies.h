@@ -0,0 +1,44 @@
+#pragma once
+
+#include "game/basic_game_engine.h"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace tictactoe {
+
+enum class PolicyType {
+    RANDOM,
+    PERFECT,
+    EPSILON_GREEDY,
+    MCTS
+};
+
+struct PolicySpec {
+    PolicyType type = PolicyType::RANDOM;
+    double epsilon = 0.1;
+    std::uint64_t playouts = 1000;
+};
+
+// Parse "random", "perfect", "epsilon[:E]" (default E = 0.1) or
+// "mcts[:P]" (default P = 1000 playouts per move)
+bool parsePolicySpec(const std::string& text, PolicySpec& spec);
+std::string describePolicy(const PolicySpec& spec);
+
+// Chooses moves for self-play. Instances are not thread-safe; create one
+// per worker.
+class MovePolicy {
+public:
+    virtual ~MovePolicy() = default;
+
+    // Pick a legal cell for the player to move; the game must be in progress
+    virtual int chooseMove(const ClassicGameEngine& engine, std::mt19937_64& rng) = 0;
+};
+
+std::unique_ptr<MovePolicy> makePolicy(const PolicySpec& spec);
+
+// Uniformly random cell from a non-empty mask
+int randomCell(ClassicGameEngine::Mask mask, std::mt19937_64& rng);
+
+} // namespace tictactoe
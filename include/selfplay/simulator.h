@@ -0,0 +1,39 @@
+#pragma once
+
+#include "selfplay/latency_histogram.h"
+#include "selfplay/policies.h"
+#include <cstdint>
+
+namespace tictactoe {
+
+struct SelfPlayConfig {
+    std::uint64_t games = 100000;
+    PolicySpec xPolicy;
+    PolicySpec oPolicy;
+    unsigned threads = 0;             // 0 = one per hardware thread
+    std::uint64_t seed = 1;
+    std::uint64_t gamesPerTask = 256; // unit of work handed to the pool
+};
+
+struct SelfPlayReport {
+    std::uint64_t games = 0;
+    std::uint64_t xWins = 0;
+    std::uint64_t oWins = 0;
+    std::uint64_t draws = 0;
+    std::uint64_t moves = 0;
+    double seconds = 0.0;
+    unsigned threads = 0;
+
+    // Time spent choosing each move, per side
+    LatencyHistogram xLatency;
+    LatencyHistogram oLatency;
+
+    double gamesPerSecond() const;
+};
+
+// Play config.games games on a work-stealing pool. Every task seeds its own
+// generator from the config seed and its index, so the outcome counts do
+// not depend on the thread count.
+SelfPlayReport runSelfPlay(const SelfPlayConfig& config);
+
+} // namespace tictactoe
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <QWidget>
+#include <array>
 #include <memory>
 #include <QPushButton>
 #include "../game/gameengine.h"
+#include "../game/move_delta_batcher.h"
 
 namespace Ui {
 class GameBoard;
@@ -24,9 +26,9 @@ public:
 
 private slots:
     void onCellClicked();
-    void onGameStateChanged(GameState newState);
-    void onCurrentPlayerChanged(Player newPlayer);
-    void onBoardChanged();
+    void onMovesApplied(const QVector<tictactoe::MoveDelta>& deltas);
+    void onGameReset();
+    void onAIThinkingChanged(bool thinking);
 
 private:
     void setupBoard();
@@ -38,5 +40,8 @@ private:
 
     std::unique_ptr<Ui::GameBoard> ui_;
     GameEngine* gameEngine_;
-    QPushButton* cells_[3][3];
-}; 
\ No newline at end of file
+    MoveDeltaBatcher* batcher_;
+    std::array<std::array<QPushButton*, GameEngine::kBoardSize>, GameEngine::kBoardSize> cells_;
+};
+
+} // namespace tictactoe
@@ -3,6 +3,7 @@
 #include <QMainWindow>
 #include <memory>
 #include "../game/gameengine.h"
+#include "../game/move_delta_batcher.h"
 #include "../auth/user_manager.h"
 #include "../database/db_manager.h"
 
@@ -19,11 +20,13 @@ public:
     explicit MainWindow(QWidget* parent = nullptr);
     ~MainWindow();
 
+protected:
+    void closeEvent(QCloseEvent* event) override;
+
 private slots:
-    void onGameStateChanged(GameState newState);
-    void onCurrentPlayerChanged(Player newPlayer);
-    void onBoardChanged();
-    void onGameOver(GameState finalState);
+    void onMovesApplied(const QVector<tictactoe::MoveDelta>& deltas);
+    void onGameReset();
+    void onAIThinkingChanged(bool thinking);
     void onUserLoggedIn(const User& user);
     void onUserLoggedOut();
     void onLoginFailed(const std::string& error);
@@ -36,9 +39,12 @@ private:
     void showGameBoard();
     void showGameHistory();
     void saveGameState();
+    void showGameOver(GameState finalState);
 
     std::unique_ptr<Ui::MainWindow> ui_;
     std::unique_ptr<GameEngine> gameEngine_;
     std::unique_ptr<UserManager> userManager_;
     std::unique_ptr<DatabaseManager> dbManager_;
-}; 
\ No newline at end of file
+};
+
+} // namespace tictactoe
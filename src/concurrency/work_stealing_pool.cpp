@@ -0,0 +1,146 @@
+#include "concurrency/work_stealing_pool.h"
+#include <algorithm>
+#include <chrono>
+
+namespace tictactoe {
+
+namespace {
+
+thread_local int tlsWorkerIndex = -1;
+thread_local const WorkStealingPool* tlsPool = nullptr;
+
+constexpr std::chrono::milliseconds kParkTimeout(50);
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount)
+    : queued_(0)
+    , pending_(0)
+    , nextQueue_(0)
+    , stopping_(false)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    unsigned index;
+    if (tlsPool == this) {
+        index = static_cast<unsigned>(tlsWorkerIndex);
+    } else {
+        index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
+
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // Publish under the state lock so a worker about to sleep sees it
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        queued_.fetch_add(1, std::memory_order_relaxed);
+    }
+    workAvailable_.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> lock(stateMutex_);
+    while (!allDone_.wait_for(lock, kParkTimeout, [this] {
+        return pending_.load(std::memory_order_acquire) == 0;
+    })) {
+    }
+}
+
+unsigned WorkStealingPool::getThreadCount() const
+{
+    return static_cast<unsigned>(workers_.size());
+}
+
+int WorkStealingPool::currentWorkerIndex()
+{
+    return tlsWorkerIndex;
+}
+
+void WorkStealingPool::workerLoop(unsigned index)
+{
+    tlsWorkerIndex = static_cast<int>(index);
+    tlsPool = this;
+
+    Task task;
+    while (true) {
+        if (popLocal(index, task) || steal(index, task)) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            task();
+            task = nullptr;
+
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(stateMutex_);
+                allDone_.notify_all();
+            }
+            continue;
+        }
+
+        // Park until there is work; the timeout bounds how long a worker
+        // can sleep if it races with a submit on another thread
+        std::unique_lock<std::mutex> lock(stateMutex_);
+        workAvailable_.wait_for(lock, kParkTimeout, [this] {
+            return stopping_ || queued_.load(std::memory_order_relaxed) > 0;
+        });
+        if (stopping_ && queued_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::popLocal(unsigned index, Task& task)
+{
+    Queue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief, Task& task)
+{
+    const std::size_t count = queues_.size();
+    for (std::size_t offset = 1; offset < count; ++offset) {
+        Queue& victim = *queues_[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace tictactoe
@@ -1,136 +1,801 @@
 #include "game/ai_opponent.h"
+#include "game/classic_solution.h"
+#include "game/proof_solver.h"
+#include "game/retrograde_solver.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace tictactoe {
 
-std::pair<int, int> AIOpponent::calculateBestMove(const std::array<std::array<Player, 3>, 3>& board, Player aiPlayer)
-{
-    int bestScore = std::numeric_limits<int>::min();
-    std::pair<int, int> bestMove = {-1, -1};
-
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            if (board[i][j] == Player::NONE) {
-                auto tempBoard = board;
-                tempBoard[i][j] = aiPlayer;
-                int score = minimax(tempBoard, 0, false, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), aiPlayer);
-                
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestMove = {i, j};
-                }
+namespace {
+
+// Terminal scores shrink with the ply so quicker wins are preferred. Anything
+// past kDecisiveScore is a proven result; heuristic scores stay well below.
+constexpr int kWinScore = 30000;
+constexpr int kInfinity = kWinScore + 1;
+constexpr int kDecisiveScore = kWinScore - 1000;
+constexpr int kMaxHeuristic = 10000;
+
+// Value of a line holding `count` stones of one side and none of the other
+constexpr int kLineWeights[] = {0, 1, 4, 16, 64, 256, 1024};
+
+// Win and loss scores are stored relative to the node instead of the root,
+// so an entry stays valid when the position is reached at another ply
+int toTableScore(int score, int ply)
+{
+    if (score > kDecisiveScore) {
+        return score + ply;
+    }
+    return (score < -kDecisiveScore) ? score - ply : score;
+}
+
+int fromTableScore(int score, int ply)
+{
+    if (score > kDecisiveScore) {
+        return score - ply;
+    }
+    return (score < -kDecisiveScore) ? score + ply : score;
+}
+
+template <typename Engine>
+std::array<int, Engine::kCells> makeRootOrder()
+{
+    constexpr int kSize = Engine::kSize;
+    std::array<int, Engine::kCells> order;
+    for (int cell = 0; cell < Engine::kCells; ++cell) {
+        order[cell] = cell;
+    }
+    // Doubled Manhattan distance from the centre, over every axis
+    auto distance = [](int cell) {
+        int total = 0;
+        for (int axis = 0; axis < Engine::kDimensions; ++axis, cell /= kSize) {
+            total += std::abs(2 * (cell % kSize) - (kSize - 1));
+        }
+        return total;
+    };
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return distance(a) < distance(b);
+    });
+    return order;
+}
+
+template <typename Engine>
+std::array<int, Engine::kCells> makeMoveOrder()
+{
+    // Root order is already centre first; a stable sort keeps that as the
+    // tie-break between cells on equally many lines
+    auto order = makeRootOrder<Engine>();
+    std::stable_sort(order.begin(), order.end(), [](int a, int b) {
+        return Engine::Lines::kByCell.counts[a] > Engine::Lines::kByCell.counts[b];
+    });
+    return order;
+}
+
+} // namespace
+
+template <typename Engine>
+const std::array<int, Engine::kCells> BasicAIOpponent<Engine>::kRootOrder = makeRootOrder<Engine>();
+
+template <typename Engine>
+const std::array<int, Engine::kCells> BasicAIOpponent<Engine>::kMoveOrder = makeMoveOrder<Engine>();
+
+template <typename Engine>
+BasicAIOpponent<Engine>::BasicAIOpponent(std::size_t tableCapacity)
+    : table_(tableCapacity)
+    , parallelMode_(ParallelMode::LAZY_SMP)
+    , workers_(1)
+    , nodeShare_(0)
+    , stop_(false)
+    , threatDepth_(Engine::kCells <= 64 ? kDefaultThreatDepth : 0)
+{
+}
+
+template <typename Engine>
+std::pair<int, int> BasicAIOpponent<Engine>::calculateBestMove(const Board& board, Player aiPlayer)
+{
+    engine_.setBoard(board, aiPlayer);
+
+    // A board that already has a line leaves every move scored the same;
+    // answer with the first empty cell as a full search would
+    int cell = -1;
+    if (engine_.isGameOver()) {
+        stats_ = SearchStats{};
+        const auto empty = static_cast<typename Engine::Mask>(
+            Engine::kFullBoard & ~(engine_.getPlayerMask(Player::X) | engine_.getPlayerMask(Player::O)));
+        for (const int candidate : kRootOrder) {
+            if (hasCell(empty, candidate)) {
+                cell = candidate;
+                break;
             }
         }
+    } else {
+        cell = searchRoot();
     }
 
-    return bestMove;
+    if (cell < 0) {
+        return {-1, -1};
+    }
+    return {cell / Engine::kSize, cell % Engine::kSize};
 }
 
-int AIOpponent::minimax(std::array<std::array<Player, 3>, 3> board,
-                       int depth,
-                       bool isMaximizing,
-                       int alpha,
-                       int beta,
-                       Player aiPlayer)
+template <typename Engine>
+int BasicAIOpponent<Engine>::calculateBestMove(const Engine& engine)
 {
-    int score = evaluateBoard(board, aiPlayer);
+    if (engine.isGameOver()) {
+        stats_ = SearchStats{};
+        return -1;
+    }
+    engine_ = engine;
+    return searchRoot();
+}
 
-    if (score != 0) {
-        return score;
+template <typename Engine>
+int BasicAIOpponent<Engine>::searchRoot()
+{
+    const Clock::time_point start = Clock::now();
+    for (Worker& worker : workers_) {
+        worker.engine = engine_;
+        worker.stats = SearchStats{};
+        worker.nextClockCheck = 0;
     }
 
-    if (!hasEmptyCells(board)) {
-        return 0;
+    const int move = chooseMove();
+
+    // Depth is the main thread's; helpers in Lazy SMP may be a ply apart
+    stats_ = SearchStats{};
+    for (const Worker& worker : workers_) {
+        stats_.nodes += worker.stats.nodes;
+        stats_.expandedNodes += worker.stats.expandedNodes;
+        stats_.cutoffs += worker.stats.cutoffs;
+        stats_.firstMoveCutoffs += worker.stats.firstMoveCutoffs;
+        stats_.tableHits += worker.stats.tableHits;
+        stats_.tableMisses += worker.stats.tableMisses;
+        stats_.tableCutoffs += worker.stats.tableCutoffs;
+        stats_.proofNodes += worker.stats.proofNodes;
+        stats_.maxPly = std::max(stats_.maxPly, worker.stats.maxPly);
     }
+    stats_.completedDepth = workers_[0].stats.completedDepth;
+    stats_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+    if (statsCallback_) {
+        statsCallback_(stats_);
+    }
+    return move;
+}
 
-    if (isMaximizing) {
-        int bestScore = std::numeric_limits<int>::min();
-        for (int i = 0; i < 3; ++i) {
-            for (int j = 0; j < 3; ++j) {
-                if (board[i][j] == Player::NONE) {
-                    board[i][j] = aiPlayer;
-                    int score = minimax(board, depth + 1, false, alpha, beta, aiPlayer);
-                    board[i][j] = Player::NONE;
-                    bestScore = std::max(score, bestScore);
-                    alpha = std::max(alpha, bestScore);
-                    if (beta <= alpha) {
-                        break;
-                    }
-                }
+template <typename Engine>
+int BasicAIOpponent<Engine>::chooseMove()
+{
+    Worker& main = workers_[0];
+
+    // The 3x3 game is solved at compile time; search only positions whose
+    // stone counts do not match the side to move
+    if constexpr (std::is_same_v<Engine, ClassicGameEngine>) {
+        const int xCount = cellCount(engine_.getPlayerMask(Player::X));
+        const int oCount = cellCount(engine_.getPlayerMask(Player::O));
+        if (xCount == oCount + (engine_.getCurrentPlayer() == Player::O ? 1 : 0)) {
+            const ClassicSolution::Entry entry = ClassicSolution::lookup(engine_.getPositionIndex());
+            if (entry.move >= 0) {
+                main.stats.completedDepth = Engine::kCells - xCount - oCount;
+                return entry.move;
             }
         }
-        return bestScore;
+    }
+
+    if constexpr (OutcomeTable<Engine>::kAvailable) {
+        if (outcomeTable_) {
+            const int move = outcomeTable_->bestMove(main.engine, kRootOrder);
+            if (move >= 0) {
+                main.stats.completedDepth = cellCount(engine_.getLegalMoves());
+                return move;
+            }
+        }
+    }
+
+    if (proofSolver_) {
+        const ProofResult result = proofSolver_->prove(main.engine, engine_.getCurrentPlayer());
+        main.stats.proofNodes = proofSolver_->getNodeCount();
+        if (result == ProofResult::PROVEN) {
+            main.stats.completedDepth = cellCount(engine_.getLegalMoves());
+            return proofSolver_->getProvenMove();
+        }
+    }
+
+    table_.newSearch();
+    stop_.store(false, std::memory_order_relaxed);
+    deadline_ = Clock::now() + limits_.moveTime;
+    nodeShare_ = std::max<std::uint64_t>(limits_.maxNodes / workers_.size(), 1);
+
+    int bestMove = -1;
+    if (workers_.size() == 1 || parallelMode_ == ParallelMode::ROOT_SPLIT) {
+        bestMove = deepen(main, 0, workers_.size() > 1);
     } else {
-        int bestScore = std::numeric_limits<int>::max();
-        for (int i = 0; i < 3; ++i) {
-            for (int j = 0; j < 3; ++j) {
-                if (board[i][j] == Player::NONE) {
-                    board[i][j] = getOpponent(aiPlayer);
-                    int score = minimax(board, depth + 1, true, alpha, beta, aiPlayer);
-                    board[i][j] = Player::NONE;
-                    bestScore = std::min(score, bestScore);
-                    beta = std::min(beta, bestScore);
-                    if (beta <= alpha) {
-                        break;
-                    }
+        // Lazy SMP: helpers run the same search with rotated root orders
+        // until the main search is done; only the main result is used
+        const int rootMoves = cellCount(engine_.getLegalMoves());
+        for (std::size_t i = 1; i < workers_.size(); ++i) {
+            helpers_->submit([this, i, rootMoves] {
+                deepen(workers_[i], static_cast<int>(i) % rootMoves, false);
+            });
+        }
+        bestMove = deepen(main, 0, false);
+        stop_.store(true, std::memory_order_relaxed);
+        helpers_->wait();
+    }
+
+    // Out of budget before the first root move finished
+    if (bestMove < 0) {
+        const auto legal = engine_.getLegalMoves();
+        for (const int cell : kRootOrder) {
+            if (hasCell(legal, cell)) {
+                return cell;
+            }
+        }
+    }
+    return bestMove;
+}
+
+template <typename Engine>
+int BasicAIOpponent<Engine>::deepen(Worker& worker, int rootOffset, bool splitRoot)
+{
+    const int emptyCells = cellCount(worker.engine.getLegalMoves());
+
+    int bestMove = -1;
+    int bestScore = -kInfinity;
+    if (limits_.isUnlimited()) {
+        if (splitRoot) {
+            searchIterationSplit(emptyCells, -1, bestMove, bestScore);
+        } else {
+            searchIteration(worker, emptyCells, -1, rootOffset, bestMove, bestScore);
+        }
+        worker.stats.completedDepth = emptyCells;
+        return bestMove;
+    }
+
+    // Iterative deepening: each pass starts with the previous best move, so
+    // even an unfinished pass can only replace it with a proven improvement
+    const int maxDepth = (limits_.maxDepth > 0) ? std::min(limits_.maxDepth, emptyCells) : emptyCells;
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        int move = -1;
+        int score = -kInfinity;
+        const bool finished = splitRoot ? searchIterationSplit(depth, bestMove, move, score)
+                                        : searchIteration(worker, depth, bestMove, rootOffset, move, score);
+        if (move >= 0) {
+            bestMove = move;
+            bestScore = score;
+        }
+        if (!finished) {
+            break;
+        }
+        worker.stats.completedDepth = depth;
+        // A win inside the horizon is the quickest there is; one found by
+        // a threat search past it may still be beaten by a deeper pass
+        if (bestScore > kWinScore - depth) {
+            break;
+        }
+    }
+    return bestMove;
+}
+
+template <typename Engine>
+bool BasicAIOpponent<Engine>::searchIteration(Worker& worker, int depth, int firstMove, int rootOffset,
+                                              int& bestMove, int& bestScore)
+{
+    // Root moves are tried in a fixed order and only a strictly better score
+    // replaces the best move, so ties always go the same way. Later moves
+    // only need to prove they beat the best so far.
+    const auto legal = worker.engine.getLegalMoves();
+    ++worker.stats.expandedNodes;
+    for (int n = -1; n < Engine::kCells; ++n) {
+        const int cell = (n < 0) ? firstMove : kRootOrder[(n + rootOffset) % Engine::kCells];
+        if (cell < 0 || (n >= 0 && cell == firstMove) || !hasCell(legal, cell)) {
+            continue;
+        }
+
+        const int score = searchRootMove(worker, cell, depth, bestScore);
+        if (stop_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = cell;
+        }
+    }
+    return true;
+}
+
+template <typename Engine>
+bool BasicAIOpponent<Engine>::searchIterationSplit(int depth, int firstMove, int& bestMove, int& bestScore)
+{
+    const auto legal = engine_.getLegalMoves();
+    std::array<int, Engine::kCells> moves;
+    int count = 0;
+    if (firstMove >= 0) {
+        moves[count++] = firstMove;
+    }
+    for (const int cell : kRootOrder) {
+        if (cell != firstMove && hasCell(legal, cell)) {
+            moves[count++] = cell;
+        }
+    }
+
+    // Every move is searched with alpha at the best score seen on any thread
+    // so far, as the single-threaded pass would. A score above its alpha is
+    // exact; one at or below it is only an upper bound.
+    std::array<int, Engine::kCells> scores;
+    std::array<int, Engine::kCells> alphas;
+    std::array<std::uint8_t, Engine::kCells> finished{};
+    std::atomic<int> next(1);
+    std::atomic<int> sharedBest(-kInfinity);
+
+    // The first (best ordered) move is searched alone so the others start
+    // with a real bound, then the rest are shared out
+    if (count == 0) {
+        return true;
+    }
+    ++workers_[0].stats.expandedNodes;
+    alphas[0] = -kInfinity;
+    scores[0] = searchRootMove(workers_[0], moves[0], depth, alphas[0]);
+    if (stop_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    finished[0] = 1;
+    sharedBest.store(scores[0]);
+
+    runOnWorkers([&](Worker& worker) {
+        for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            alphas[i] = sharedBest.load();
+            const int score = searchRootMove(worker, moves[i], depth, alphas[i]);
+            if (stop_.load(std::memory_order_relaxed)) {
+                return;
+            }
+            scores[i] = score;
+            finished[i] = 1;
+
+            int seen = sharedBest.load();
+            while (score > seen && !sharedBest.compare_exchange_weak(seen, score)) {
+            }
+        }
+    });
+
+    const bool stopped = stop_.load(std::memory_order_relaxed);
+    int best = -kInfinity;
+    for (int i = 0; i < count; ++i) {
+        if (finished[i] && scores[i] > alphas[i]) {
+            best = std::max(best, scores[i]);
+        }
+    }
+
+    // The single-threaded pass keeps the first move in root order that
+    // reaches the best score. A bound equal to the best might hide a tie
+    // with a move found later, so it is searched again to settle it.
+    for (int i = 0; i < count; ++i) {
+        if (!finished[i] || scores[i] < best) {
+            continue;
+        }
+        if (scores[i] <= alphas[i] && !stopped) {
+            if (searchRootMove(workers_[0], moves[i], depth, best - 1) < best) {
+                if (stop_.load(std::memory_order_relaxed)) {
+                    return false;
                 }
+                continue;
             }
+        } else if (scores[i] <= alphas[i]) {
+            continue;
         }
-        return bestScore;
+        bestScore = best;
+        bestMove = moves[i];
+        break;
     }
+    return !stop_.load(std::memory_order_relaxed);
 }
 
-int AIOpponent::evaluateBoard(const std::array<std::array<Player, 3>, 3>& board, Player aiPlayer) const
+template <typename Engine>
+int BasicAIOpponent<Engine>::searchRootMove(Worker& worker, int cell, int depth, int alpha)
 {
-    // Check rows
-    for (int i = 0; i < 3; ++i) {
-        if (board[i][0] != Player::NONE &&
-            board[i][0] == board[i][1] &&
-            board[i][1] == board[i][2]) {
-            return (board[i][0] == aiPlayer) ? 10 : -10;
+    worker.engine.makeMove(cell);
+    ++worker.stats.nodes;
+    int score = 0;
+    switch (worker.engine.getGameState()) {
+        case GameState::IN_PROGRESS:
+            score = -negamax(worker, 1, depth - 1, -kInfinity, -alpha);
+            break;
+        case GameState::DRAW:
+            break;
+        default:
+            score = kWinScore;
+            break;
+    }
+    worker.engine.undoMove();
+    return score;
+}
+
+template <typename Engine>
+int BasicAIOpponent<Engine>::negamax(Worker& worker, int ply, int depth, int alpha, int beta)
+{
+    if (outOfBudget(worker)) {
+        return 0;
+    }
+
+    Engine& engine = worker.engine;
+    const auto legal = engine.getLegalMoves();
+    const int emptyCells = cellCount(legal);
+    worker.stats.maxPly = std::max(worker.stats.maxPly, ply);
+
+    // A line one stone from complete settles the node: the mover completes
+    // it. Otherwise every move but a block on the opponent's threats loses
+    // on the next ply, so only the blocks are searched.
+    const Player mover = engine.getCurrentPlayer();
+    if (depth <= 0) {
+        // Past the horizon only with threat search on: a win forced by
+        // threats alone is worth more than any static score
+        if (threatDepth_ > 0) {
+            if (!isEmptyMask(engine.getThreats(mover))) {
+                return kWinScore - ply;
+            }
+            const int threats = threatWin(worker, threatDepth_);
+            if (threats > 0) {
+                return kWinScore - ply - 2 * threats;
+            }
         }
+        return evaluatePosition(engine);
+    }
+    if (!isEmptyMask(engine.getThreats(mover))) {
+        return kWinScore - ply;
     }
+    auto moves = legal;
+    const auto blocks = engine.getThreats(mover == Player::X ? Player::O : Player::X);
+    if (!isEmptyMask(blocks)) {
+        moves = static_cast<typename Engine::Mask>(moves & blocks);
+    }
+
+    // Searching deeper than the cells left is an exact solve, so entries
+    // count as deep enough once they cover every remaining cell
+    const int draft = std::min(depth, emptyCells);
+    const std::uint64_t key = engine.getZobristKey();
 
-    // Check columns
-    for (int i = 0; i < 3; ++i) {
-        if (board[0][i] != Player::NONE &&
-            board[0][i] == board[1][i] &&
-            board[1][i] == board[2][i]) {
-            return (board[0][i] == aiPlayer) ? 10 : -10;
+    // Only cutoffs are taken from bounds; the window itself is left alone
+    int tableMove = -1;
+    TTEntry entry;
+    if (table_.probe(key, entry)) {
+        ++worker.stats.tableHits;
+        const int score = fromTableScore(entry.score, ply);
+        if (entry.depth >= draft &&
+            (entry.bound == Bound::EXACT ||
+             (entry.bound == Bound::LOWER && score >= beta) ||
+             (entry.bound == Bound::UPPER && score <= alpha))) {
+            ++worker.stats.tableCutoffs;
+            return score;
         }
+        tableMove = entry.move;
+    } else {
+        ++worker.stats.tableMisses;
     }
 
-    // Check diagonals
-    if (board[0][0] != Player::NONE &&
-        board[0][0] == board[1][1] &&
-        board[1][1] == board[2][2]) {
-        return (board[0][0] == aiPlayer) ? 10 : -10;
+    const int alphaOrig = alpha;
+    int bestScore = -kInfinity;
+    int bestMove = -1;
+    bool firstMove = true;
+    ++worker.stats.expandedNodes;
+
+    // The stored best move first, then the static order
+    for (int n = -1; n < Engine::kCells; ++n) {
+        const int cell = (n < 0) ? tableMove : kMoveOrder[n];
+        if (cell < 0 || cell >= Engine::kCells || (n >= 0 && cell == tableMove) || !hasCell(moves, cell)) {
+            continue;
+        }
+
+        // The engine's line counters report the end of the game as the
+        // move is made, so no node rescans the board
+        engine.makeMove(cell);
+        ++worker.stats.nodes;
+        int score = 0;
+        switch (engine.getGameState()) {
+            case GameState::IN_PROGRESS:
+                score = -negamax(worker, ply + 1, depth - 1, -beta, -alpha);
+                break;
+            case GameState::DRAW:
+                break;
+            default:
+                score = kWinScore - ply;
+                break;
+        }
+        engine.undoMove();
+
+        if (stop_.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = cell;
+        }
+        alpha = std::max(alpha, bestScore);
+        if (alpha >= beta) {
+            ++worker.stats.cutoffs;
+            worker.stats.firstMoveCutoffs += firstMove ? 1 : 0;
+            break;
+        }
+        firstMove = false;
     }
 
-    if (board[0][2] != Player::NONE &&
-        board[0][2] == board[1][1] &&
-        board[1][1] == board[2][0]) {
-        return (board[0][2] == aiPlayer) ? 10 : -10;
+    Bound bound = Bound::EXACT;
+    if (bestScore <= alphaOrig) {
+        bound = Bound::UPPER;
+    } else if (bestScore >= beta) {
+        bound = Bound::LOWER;
     }
+    table_.store(key, toTableScore(bestScore, ply), bestMove, draft, bound);
 
+    return bestScore;
+}
+
+template <typename Engine>
+int BasicAIOpponent<Engine>::threatWin(Worker& worker, int maxThreats)
+{
+    Engine& engine = worker.engine;
+    const Player attacker = engine.getCurrentPlayer();
+    const Player defender = (attacker == Player::X) ? Player::O : Player::X;
+    if (!isEmptyMask(engine.getThreats(attacker))) {
+        return 0;
+    }
+
+    // An open threat of the defender must be blocked first, and two cannot be
+    const auto defenderThreats = engine.getThreats(defender);
+    const int defenderCount = cellCount(defenderThreats);
+    if (defenderCount > 1) {
+        return 0;
+    }
+
+    // Moves that make a threat: empty cells of lines two stones short of
+    // K with no defender stone
+    auto candidates = typename Engine::Mask{};
+    const auto empty = engine.getLegalMoves();
+    for (int line = 0; line < Engine::Lines::kCount; ++line) {
+        if (engine.getLineCount(line, attacker) == Engine::kWinLength - 2 &&
+            engine.getLineCount(line, defender) == 0) {
+            candidates |= static_cast<typename Engine::Mask>(Engine::Lines::kMasks[line] & empty);
+        }
+    }
+    if (defenderCount == 1) {
+        candidates = static_cast<typename Engine::Mask>(candidates & defenderThreats);
+    }
+
+    while (!isEmptyMask(candidates)) {
+        if (outOfBudget(worker)) {
+            return 0;
+        }
+        const int cell = popLowestCell(candidates);
+        engine.makeMove(cell);
+        ++worker.stats.nodes;
+        const auto threats = engine.getThreats(attacker);
+        int found = 0;
+        if (!engine.isGameOver() && isEmptyMask(engine.getThreats(defender))) {
+            if (cellCount(threats) > 1) {
+                found = 1;
+            } else if (maxThreats > 1) {
+                // The block is forced; see if the attack goes on from there
+                engine.makeMove(lowestCell(threats));
+                ++worker.stats.nodes;
+                if (!engine.isGameOver()) {
+                    const int rest = threatWin(worker, maxThreats - 1);
+                    found = (rest > 0) ? rest + 1 : 0;
+                }
+                engine.undoMove();
+            }
+        }
+        engine.undoMove();
+        if (found > 0) {
+            return found;
+        }
+    }
     return 0;
 }
 
-bool AIOpponent::hasEmptyCells(const std::array<std::array<Player, 3>, 3>& board) const
+template <typename Engine>
+int BasicAIOpponent<Engine>::evaluatePosition(const Engine& engine)
+{
+    static_assert(Engine::kWinLength < static_cast<int>(sizeof(kLineWeights) / sizeof(kLineWeights[0])),
+                  "one weight per stone count short of a win");
+
+    // Lines still open to one side only, weighted by how full they are
+    const Player mover = engine.getCurrentPlayer();
+    const Player other = (mover == Player::X) ? Player::O : Player::X;
+    int score = 0;
+    for (int line = 0; line < Engine::Lines::kCount; ++line) {
+        const int own = engine.getLineCount(line, mover);
+        const int theirs = engine.getLineCount(line, other);
+        if (theirs == 0) {
+            score += kLineWeights[own];
+        } else if (own == 0) {
+            score -= kLineWeights[theirs];
+        }
+    }
+    return std::clamp(score, -kMaxHeuristic, kMaxHeuristic);
+}
+
+template <typename Engine>
+bool BasicAIOpponent<Engine>::outOfBudget(Worker& worker)
 {
-    for (const auto& row : board) {
-        for (const auto& cell : row) {
-            if (cell == Player::NONE) {
-                return true;
+    if (stop_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    // Any thread running out ends the whole search. Reading the clock costs
+    // more than a node, so it is only read every 256 nodes.
+    bool exhausted = (limits_.maxNodes != 0 && worker.stats.nodes >= nodeShare_) ||
+                     (limits_.cancel != nullptr && limits_.cancel->load(std::memory_order_relaxed));
+    if (!exhausted && limits_.moveTime.count() != 0 && worker.stats.nodes >= worker.nextClockCheck) {
+        worker.nextClockCheck = worker.stats.nodes + 256;
+        exhausted = Clock::now() >= deadline_;
+    }
+    if (exhausted) {
+        stop_.store(true, std::memory_order_relaxed);
+    }
+    return exhausted;
+}
+
+template <typename Engine>
+template <typename Task>
+void BasicAIOpponent<Engine>::runOnWorkers(Task&& task)
+{
+    for (std::size_t i = 1; i < workers_.size(); ++i) {
+        helpers_->submit([this, i, &task] {
+            task(workers_[i]);
+        });
+    }
+    task(workers_[0]);
+    if (helpers_) {
+        helpers_->wait();
+    }
+}
+
+template <typename Engine>
+int BasicAIOpponent<Engine>::evaluateBoard(const Board& board, Player aiPlayer) const
+{
+    // Rows, columns and diagonals come from the engine's win-line table
+    for (const auto& line : Engine::Lines::kCells) {
+        const Player first = board[line[0] / Engine::kSize][line[0] % Engine::kSize];
+        if (first == Player::NONE) {
+            continue;
+        }
+
+        bool complete = true;
+        for (int i = 1; i < Engine::kWinLength; ++i) {
+            if (board[line[i] / Engine::kSize][line[i] % Engine::kSize] != first) {
+                complete = false;
+                break;
             }
         }
+
+        if (complete) {
+            return (first == aiPlayer) ? 10 : -10;
+        }
     }
-    return false;
+
+    return 0;
+}
+
+template <typename Engine>
+TranspositionTable& BasicAIOpponent<Engine>::getTranspositionTable()
+{
+    return table_;
+}
+
+template <typename Engine>
+void BasicAIOpponent<Engine>::setSearchLimits(const SearchLimits& limits)
+{
+    limits_ = limits;
 }
 
-Player AIOpponent::getOpponent(Player player) const
+template <typename Engine>
+const SearchLimits& BasicAIOpponent<Engine>::getSearchLimits() const
 {
-    return (player == Player::X) ? Player::O : Player::X;
+    return limits_;
 }
 
-} // namespace tictactoe 
\ No newline at end of file
+template <typename Engine>
+void BasicAIOpponent<Engine>::setThreadCount(unsigned threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (threadCount == workers_.size()) {
+        return;
+    }
+    workers_.resize(threadCount);
+    helpers_.reset(threadCount > 1 ? new WorkStealingPool(threadCount - 1) : nullptr);
+}
+
+template <typename Engine>
+unsigned BasicAIOpponent<Engine>::getThreadCount() const
+{
+    return static_cast<unsigned>(workers_.size());
+}
+
+template <typename Engine>
+void BasicAIOpponent<Engine>::setParallelMode(ParallelMode mode)
+{
+    parallelMode_ = mode;
+}
+
+template <typename Engine>
+ParallelMode BasicAIOpponent<Engine>::getParallelMode() const
+{
+    return parallelMode_;
+}
+
+template <typename Engine>
+void BasicAIOpponent<Engine>::setThreatDepth(int threats)
+{
+    threatDepth_ = std::max(threats, 0);
+}
+
+template <typename Engine>
+int BasicAIOpponent<Engine>::getThreatDepth() const
+{
+    return threatDepth_;
+}
+
+template <typename Engine>
+void BasicAIOpponent<Engine>::setOutcomeTable(std::shared_ptr<const OutcomeTable<Engine>> table)
+{
+    outcomeTable_ = std::move(table);
+}
+
+template <typename Engine>
+bool BasicAIOpponent<Engine>::openTablebase(const std::string& path)
+{
+    if constexpr (OutcomeTable<Engine>::kAvailable) {
+        auto table = std::make_shared<OutcomeTable<Engine>>();
+        if (!table->load(path)) {
+            return false;
+        }
+        outcomeTable_ = std::move(table);
+        return true;
+    } else {
+        (void)path;
+        return false;
+    }
+}
+
+template <typename Engine>
+void BasicAIOpponent<Engine>::setProofSolver(std::shared_ptr<BasicProofSolver<Engine>> solver)
+{
+    proofSolver_ = std::move(solver);
+}
+
+template <typename Engine>
+const SearchStats& BasicAIOpponent<Engine>::getSearchStats() const
+{
+    return stats_;
+}
+
+template <typename Engine>
+void BasicAIOpponent<Engine>::setStatsCallback(StatsCallback callback)
+{
+    statsCallback_ = std::move(callback);
+}
+
+template <typename Engine>
+std::uint64_t BasicAIOpponent<Engine>::getNodeCount() const
+{
+    return stats_.nodes;
+}
+
+template <typename Engine>
+int BasicAIOpponent<Engine>::getCompletedDepth() const
+{
+    return stats_.completedDepth;
+}
+
+template class BasicAIOpponent<ClassicGameEngine>;
+template class BasicAIOpponent<GameEngine4x4>;
+template class BasicAIOpponent<GameEngine5x5>;
+template class BasicAIOpponent<GameEngine6x6>;
+template class BasicAIOpponent<GomokuEngine>;
+template class BasicAIOpponent<QubicEngine>;
+
+} // namespace tictactoe
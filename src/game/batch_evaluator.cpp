@@ -0,0 +1,235 @@
+#include "game/batch_evaluator.h"
+#include "batch_kernels.h"
+#include <algorithm>
+
+#if defined(TICTACTOE_HAVE_SSE2)
+#include <emmintrin.h>
+#endif
+#if defined(TICTACTOE_HAVE_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace tictactoe {
+
+namespace detail {
+
+template <typename Mask>
+void lineHitsScalarImpl(const Mask* masks, std::size_t count, const Mask* lines, int lineCount, Mask* hits)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        Mask hit = 0;
+        for (int l = 0; l < lineCount; ++l) {
+            if ((masks[i] & lines[l]) == lines[l]) {
+                hit = static_cast<Mask>(~Mask(0));
+                break;
+            }
+        }
+        hits[i] = hit;
+    }
+}
+
+void lineHitsScalar(const std::uint16_t* masks, std::size_t count,
+                    const std::uint16_t* lines, int lineCount, std::uint16_t* hits)
+{
+    lineHitsScalarImpl(masks, count, lines, lineCount, hits);
+}
+
+void lineHitsScalar(const std::uint32_t* masks, std::size_t count,
+                    const std::uint32_t* lines, int lineCount, std::uint32_t* hits)
+{
+    lineHitsScalarImpl(masks, count, lines, lineCount, hits);
+}
+
+#if defined(TICTACTOE_HAVE_SSE2)
+void lineHitsSse2(const std::uint16_t* masks, std::size_t count,
+                  const std::uint16_t* lines, int lineCount, std::uint16_t* hits)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + i));
+        __m128i hit = _mm_setzero_si128();
+        for (int l = 0; l < lineCount; ++l) {
+            const __m128i line = _mm_set1_epi16(static_cast<short>(lines[l]));
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi16(_mm_and_si128(value, line), line));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(hits + i), hit);
+    }
+    lineHitsScalar(masks + i, count - i, lines, lineCount, hits + i);
+}
+
+void lineHitsSse2(const std::uint32_t* masks, std::size_t count,
+                  const std::uint32_t* lines, int lineCount, std::uint32_t* hits)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + i));
+        __m128i hit = _mm_setzero_si128();
+        for (int l = 0; l < lineCount; ++l) {
+            const __m128i line = _mm_set1_epi32(static_cast<int>(lines[l]));
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi32(_mm_and_si128(value, line), line));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(hits + i), hit);
+    }
+    lineHitsScalar(masks + i, count - i, lines, lineCount, hits + i);
+}
+#endif
+
+} // namespace detail
+
+namespace {
+
+bool cpuHasAvx2()
+{
+#if defined(TICTACTOE_HAVE_AVX2) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(TICTACTOE_HAVE_AVX2) && defined(_MSC_VER)
+    // AVX2 needs both the CPU flag and the OS saving the YMM registers
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+SimdLevel detectOnce()
+{
+    if (cpuHasAvx2()) {
+        return SimdLevel::AVX2;
+    }
+#if defined(TICTACTOE_HAVE_SSE2)
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+// Boards per pass; the hit buffer for one pass stays on the stack
+constexpr std::size_t kChunkBoards = 256;
+
+// Result for each combination of X line (bit 0), O line (bit 1) and full
+// board (bit 2); X wins when both sides have a line
+constexpr GameState kOutcomeStates[8] = {
+    GameState::IN_PROGRESS, GameState::X_WON, GameState::O_WON, GameState::X_WON,
+    GameState::DRAW,        GameState::X_WON, GameState::O_WON, GameState::X_WON,
+};
+constexpr std::int8_t kOutcomeScores[8] = {0, 10, -10, 10, 0, 10, -10, 10};
+
+} // namespace
+
+SimdLevel detectSimdLevel()
+{
+    static const SimdLevel level = detectOnce();
+    return level;
+}
+
+const char* describeSimdLevel(SimdLevel level)
+{
+    switch (level) {
+        case SimdLevel::SCALAR:
+            return "scalar";
+        case SimdLevel::SSE2:
+            return "sse2";
+        case SimdLevel::AVX2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+template <typename Engine>
+BatchEvaluator<Engine>::BatchEvaluator(SimdLevel level)
+    : level_(std::min(level, detectSimdLevel()))
+{
+    // Only 16- and 32-bit masks have vector kernels
+    if constexpr (!std::is_same_v<Mask, std::uint16_t> && !std::is_same_v<Mask, std::uint32_t>) {
+        level_ = SimdLevel::SCALAR;
+    }
+}
+
+template <typename Engine>
+void BatchEvaluator<Engine>::evaluate(const Batch& boards, GameState* states, std::int8_t* scores) const
+{
+    constexpr auto& kLines = Engine::Lines::kMasks;
+    const std::size_t count = boards.size();
+
+    for (std::size_t start = 0; start < count; start += kChunkBoards) {
+        const std::size_t chunk = std::min(kChunkBoards, count - start);
+        // X and O masks of the chunk's boards, interleaved
+        const Mask* masks = boards.data() + 2 * start;
+
+        // Line hits for each of those masks
+        bool hits[2 * kChunkBoards];
+        if constexpr (std::is_same_v<Mask, std::uint16_t> || std::is_same_v<Mask, std::uint32_t>) {
+            Mask laneHits[2 * kChunkBoards];
+            const int lineCount = static_cast<int>(kLines.size());
+            switch (level_) {
+#if defined(TICTACTOE_HAVE_AVX2)
+                case SimdLevel::AVX2:
+                    detail::lineHitsAvx2(masks, 2 * chunk, kLines.data(), lineCount, laneHits);
+                    break;
+#endif
+#if defined(TICTACTOE_HAVE_SSE2)
+                case SimdLevel::SSE2:
+                    detail::lineHitsSse2(masks, 2 * chunk, kLines.data(), lineCount, laneHits);
+                    break;
+#endif
+                default:
+                    detail::lineHitsScalar(masks, 2 * chunk, kLines.data(), lineCount, laneHits);
+                    break;
+            }
+            for (std::size_t i = 0; i < 2 * chunk; ++i) {
+                hits[i] = laneHits[i] != 0;
+            }
+        } else {
+            for (std::size_t i = 0; i < 2 * chunk; ++i) {
+                hits[i] = false;
+                for (const Mask& line : kLines) {
+                    hits[i] = hits[i] || (masks[i] & line) == line;
+                }
+            }
+        }
+
+        // Random boards make the outcome unpredictable, so it is looked up
+        // instead of branched on
+        for (std::size_t i = 0; i < chunk; ++i) {
+            const bool full = (masks[2 * i] | masks[2 * i + 1]) == Engine::kFullBoard;
+            const int outcome = hits[2 * i] | (hits[2 * i + 1] << 1) | (full << 2);
+            if (states != nullptr) {
+                states[start + i] = kOutcomeStates[outcome];
+            }
+            if (scores != nullptr) {
+                scores[start + i] = kOutcomeScores[outcome];
+            }
+        }
+    }
+}
+
+template <typename Engine>
+SimdLevel BatchEvaluator<Engine>::getSimdLevel() const
+{
+    return level_;
+}
+
+template <typename Engine>
+void BatchEvaluator<Engine>::pack(const Engine& engine, Batch& boards)
+{
+    boards.add(engine.getPlayerMask(Player::X), engine.getPlayerMask(Player::O));
+}
+
+template class BatchEvaluator<ClassicGameEngine>;
+template class BatchEvaluator<GameEngine4x4>;
+template class BatchEvaluator<GameEngine5x5>;
+template class BatchEvaluator<GomokuEngine>;
+
+} // namespace tictactoe
@@ -0,0 +1,42 @@
+// Compiled with AVX2 enabled (see CMakeLists.txt); nothing here may run
+// before detectSimdLevel() has confirmed AVX2 support
+#include "batch_kernels.h"
+#include <immintrin.h>
+
+namespace tictactoe {
+namespace detail {
+
+void lineHitsAvx2(const std::uint16_t* masks, std::size_t count,
+                  const std::uint16_t* lines, int lineCount, std::uint16_t* hits)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + i));
+        __m256i hit = _mm256_setzero_si256();
+        for (int l = 0; l < lineCount; ++l) {
+            const __m256i line = _mm256_set1_epi16(static_cast<short>(lines[l]));
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi16(_mm256_and_si256(value, line), line));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(hits + i), hit);
+    }
+    lineHitsScalar(masks + i, count - i, lines, lineCount, hits + i);
+}
+
+void lineHitsAvx2(const std::uint32_t* masks, std::size_t count,
+                  const std::uint32_t* lines, int lineCount, std::uint32_t* hits)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + i));
+        __m256i hit = _mm256_setzero_si256();
+        for (int l = 0; l < lineCount; ++l) {
+            const __m256i line = _mm256_set1_epi32(static_cast<int>(lines[l]));
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi32(_mm256_and_si256(value, line), line));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(hits + i), hit);
+    }
+    lineHitsScalar(masks + i, count - i, lines, lineCount, hits + i);
+}
+
+} // namespace detail
+} // namespace tictactoe
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tictactoe {
+namespace detail {
+
+// Line test kernels for BatchEvaluator. Each sets hits[i] to all ones if
+// masks[i] contains one of the `lineCount` line masks, and to 0 otherwise.
+// masks and hits may have any alignment.
+
+void lineHitsScalar(const std::uint16_t* masks, std::size_t count,
+                    const std::uint16_t* lines, int lineCount, std::uint16_t* hits);
+void lineHitsScalar(const std::uint32_t* masks, std::size_t count,
+                    const std::uint32_t* lines, int lineCount, std::uint32_t* hits);
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TICTACTOE_HAVE_SSE2 1
+void lineHitsSse2(const std::uint16_t* masks, std::size_t count,
+                  const std::uint16_t* lines, int lineCount, std::uint16_t* hits);
+void lineHitsSse2(const std::uint32_t* masks, std::size_t count,
+                  const std::uint32_t* lines, int lineCount, std::uint32_t* hits);
+#endif
+
+// Built in batch_evaluator_avx2.cpp with AVX2 enabled; only call after
+// checking the CPU
+#if defined(TICTACTOE_HAVE_AVX2)
+void lineHitsAvx2(const std::uint16_t* masks, std::size_t count,
+                  const std::uint16_t* lines, int lineCount, std::uint16_t* hits);
+void lineHitsAvx2(const std::uint32_t* masks, std::size_t count,
+                  const std::uint32_t* lines, int lineCount, std::uint32_t* hits);
+#endif
+
+} // namespace detail
+} // namespace tictactoe
@@ -0,0 +1,117 @@
+#include "game/classic_solution.h"
+#include <array>
+
+namespace tictactoe {
+
+namespace {
+
+using Engine = ClassicGameEngine;
+
+struct SolutionTable {
+    std::array<ClassicSolution::Entry, ClassicSolution::kPositions> entries{};
+};
+
+constexpr bool hasLine(Engine::Mask mask)
+{
+    for (const auto line : Engine::Lines::kMasks) {
+        if ((mask & line) == line) {
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr SolutionTable solveClassic()
+{
+    constexpr auto& powers = PositionIndex<Engine::kCells>::kPowers;
+
+    // Cells nearest the centre first, row-major within a ring, the same
+    // order BasicAIOpponent tries root moves in
+    std::array<int, Engine::kCells> order{};
+    int filled = 0;
+    for (int ring = 0; ring <= 2 * (Engine::kSize - 1); ++ring) {
+        for (int cell = 0; cell < Engine::kCells; ++cell) {
+            const int row = 2 * (cell / Engine::kSize) - (Engine::kSize - 1);
+            const int col = 2 * (cell % Engine::kSize) - (Engine::kSize - 1);
+            if ((row < 0 ? -row : row) + (col < 0 ? -col : col) == ring) {
+                order[filled++] = cell;
+            }
+        }
+    }
+
+    // A child has one more stone and so a larger index: solve from the top
+    SolutionTable table{};
+    for (int index = ClassicSolution::kPositions - 1; index >= 0; --index) {
+        ClassicSolution::Entry& entry = table.entries[index];
+        entry = ClassicSolution::Entry{-1, 0};
+
+        Engine::Mask xMask = 0;
+        Engine::Mask oMask = 0;
+        int xCount = 0;
+        int oCount = 0;
+        int rest = index;
+        for (int cell = 0; cell < Engine::kCells; ++cell, rest /= 3) {
+            if (rest % 3 == 1) {
+                xMask |= maskOf<Engine::Mask>(cell);
+                ++xCount;
+            } else if (rest % 3 == 2) {
+                oMask |= maskOf<Engine::Mask>(cell);
+                ++oCount;
+            }
+        }
+
+        if (xCount != oCount && xCount != oCount + 1) {
+            continue;
+        }
+        if (hasLine(xMask) || hasLine(oMask)) {
+            entry.score = -10;
+            continue;
+        }
+        if (xCount + oCount == Engine::kCells) {
+            continue;
+        }
+
+        const bool xToMove = xCount == oCount;
+        const Engine::Mask occupied = xMask | oMask;
+        int bestScore = -128;
+        for (const int cell : order) {
+            if (hasCell(occupied, cell)) {
+                continue;
+            }
+            const auto child = static_cast<std::size_t>(index) + powers[cell] * (xToMove ? 1 : 2);
+            const int childScore = table.entries[child].score;
+
+            // One ply further from the end than the child
+            int score = -childScore;
+            score += (score > 0) ? -1 : ((score < 0) ? 1 : 0);
+            if (score > bestScore) {
+                bestScore = score;
+                entry.move = static_cast<std::int8_t>(cell);
+            }
+        }
+        entry.score = static_cast<std::int8_t>(bestScore);
+    }
+    return table;
+}
+
+constexpr SolutionTable kSolution = solveClassic();
+
+static_assert(kSolution.entries[0].score == 0, "the 3x3 game is a draw");
+static_assert(kSolution.entries[0].move == 4, "ties favour the centre");
+
+} // namespace
+
+ClassicSolution::Entry ClassicSolution::lookup(std::uint64_t positionIndex)
+{
+    if (positionIndex >= static_cast<std::uint64_t>(kPositions)) {
+        return Entry{-1, 0};
+    }
+    return kSolution.entries[positionIndex];
+}
+
+ClassicSolution::Entry ClassicSolution::lookup(const ClassicGameEngine& engine)
+{
+    return lookup(engine.getPositionIndex());
+}
+
+} // namespace tictactoe
@@ -1,138 +1,187 @@
 #include "game/gameengine.h"
-#include <algorithm>
 
 namespace tictactoe {
 
 GameEngine::GameEngine(QObject* parent)
     : QObject(parent)
-    , currentPlayer_(Player::X)
-    , gameState_(GameState::IN_PROGRESS)
     , isVsAI_(false)
+    , pondering_(true)
+    , aiRequest_(0)
+    , aiThinking_(false)
 {
     resetGame();
 }
 
+GameEngine::~GameEngine()
+{
+    // Join the search thread before the members it uses go away
+    ai_.cancel();
+}
+
 bool GameEngine::makeMove(int row, int col)
 {
-    if (!isValidMove(row, col)) {
+    if (aiThinking_ || row < 0 || row >= kBoardSize || col < 0 || col >= kBoardSize) {
         return false;
     }
-
-    board_[row][col] = currentPlayer_;
-    emit boardChanged();
-
-    if (checkWin()) {
-        gameState_ = (currentPlayer_ == Player::X) ? GameState::X_WON : GameState::O_WON;
-        emit gameStateChanged(gameState_);
-        emit gameOver(gameState_);
-        return true;
-    }
-
-    if (checkDraw()) {
-        gameState_ = GameState::DRAW;
-        emit gameStateChanged(gameState_);
-        emit gameOver(gameState_);
-        return true;
+    if (!applyMove(row * kBoardSize + col)) {
+        return false;
     }
-
-    switchPlayer();
+    startAIMoveIfDue();
     return true;
 }
 
 void GameEngine::resetGame()
 {
-    for (auto& row : board_) {
-        std::fill(row.begin(), row.end(), Player::NONE);
-    }
-    currentPlayer_ = Player::X;
-    gameState_ = GameState::IN_PROGRESS;
-    emit boardChanged();
-    emit currentPlayerChanged(currentPlayer_);
-    emit gameStateChanged(gameState_);
+    cancelAIMove();
+    engine_.resetGame();
+    emit gameReset();
 }
 
 void GameEngine::setGameMode(bool isVsAI)
 {
     isVsAI_ = isVsAI;
+    if (isVsAI_) {
+        startAIMoveIfDue();
+    } else {
+        cancelAIMove();
+    }
+}
+
+bool GameEngine::isVsAI() const
+{
+    return isVsAI_;
 }
 
 GameState GameEngine::getGameState() const
 {
-    return gameState_;
+    return engine_.getGameState();
 }
 
 Player GameEngine::getCurrentPlayer() const
 {
-    return currentPlayer_;
+    return engine_.getCurrentPlayer();
 }
 
-const std::array<std::array<Player, 3>, 3>& GameEngine::getBoard() const
+GameEngine::Board GameEngine::getBoard() const
 {
-    return board_;
+    return engine_.getBoard();
 }
 
 bool GameEngine::isGameOver() const
 {
-    return gameState_ != GameState::IN_PROGRESS;
+    return engine_.isGameOver();
 }
 
-bool GameEngine::checkWin() const
+BoardMask GameEngine::getPlayerMask(Player player) const
 {
-    // Check rows
-    for (int i = 0; i < 3; ++i) {
-        if (board_[i][0] != Player::NONE &&
-            board_[i][0] == board_[i][1] &&
-            board_[i][1] == board_[i][2]) {
-            return true;
-        }
-    }
+    return engine_.getPlayerMask(player);
+}
 
-    // Check columns
-    for (int i = 0; i < 3; ++i) {
-        if (board_[0][i] != Player::NONE &&
-            board_[0][i] == board_[1][i] &&
-            board_[1][i] == board_[2][i]) {
-            return true;
-        }
-    }
+BoardMask GameEngine::getLegalMoves() const
+{
+    return engine_.getLegalMoves();
+}
 
-    // Check diagonals
-    if (board_[0][0] != Player::NONE &&
-        board_[0][0] == board_[1][1] &&
-        board_[1][1] == board_[2][2]) {
-        return true;
-    }
+std::uint64_t GameEngine::getZobristKey() const
+{
+    return engine_.getZobristKey();
+}
+
+std::uint64_t GameEngine::getPositionIndex() const
+{
+    return engine_.getPositionIndex();
+}
 
-    if (board_[0][2] != Player::NONE &&
-        board_[0][2] == board_[1][1] &&
-        board_[1][1] == board_[2][0]) {
-        return true;
+const ClassicGameEngine& GameEngine::core() const
+{
+    return engine_;
+}
+
+bool GameEngine::isAIThinking() const
+{
+    return aiThinking_;
+}
+
+void GameEngine::cancelAIMove()
+{
+    ++aiRequest_;
+    ai_.cancel();
+    setAIThinking(false);
+}
+
+void GameEngine::setAISearchLimits(const SearchLimits& limits)
+{
+    cancelAIMove();
+    ai_.setSearchLimits(limits);
+    startAIMoveIfDue();
+}
+
+void GameEngine::setPondering(bool enabled)
+{
+    pondering_ = enabled;
+    if (!pondering_ && ai_.isPondering()) {
+        ai_.cancel();
     }
+}
 
-    return false;
+bool GameEngine::isPonderingEnabled() const
+{
+    return pondering_;
 }
 
-bool GameEngine::checkDraw() const
+bool GameEngine::applyMove(int cell)
 {
-    for (const auto& row : board_) {
-        for (const auto& cell : row) {
-            if (cell == Player::NONE) {
-                return false;
-            }
-        }
+    const Player mover = engine_.getCurrentPlayer();
+    if (!engine_.makeMove(cell)) {
+        return false;
     }
+
+    MoveDelta delta;
+    delta.cell = cell;
+    delta.player = mover;
+    delta.state = engine_.getGameState();
+    delta.nextPlayer = engine_.isGameOver() ? Player::NONE : engine_.getCurrentPlayer();
+    emit moveApplied(delta);
     return true;
 }
 
-void GameEngine::switchPlayer()
+void GameEngine::startAIMoveIfDue()
+{
+    if (!isVsAI_ || aiThinking_ || engine_.isGameOver() || engine_.getCurrentPlayer() != kAIPlayer) {
+        return;
+    }
+
+    // The result comes back on the search thread; queue it to this thread
+    const quint64 request = ++aiRequest_;
+    setAIThinking(true);
+    ai_.start(engine_, [this, request](int cell) {
+        QMetaObject::invokeMethod(this, [this, request, cell] {
+            onAIMoveReady(request, cell);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void GameEngine::onAIMoveReady(quint64 request, int cell)
 {
-    currentPlayer_ = (currentPlayer_ == Player::X) ? Player::O : Player::X;
-    emit currentPlayerChanged(currentPlayer_);
+    if (request != aiRequest_) {
+        return;
+    }
+    setAIThinking(false);
+    applyMove(cell);
+
+    // Use the human's thinking time
+    if (pondering_ && !engine_.isGameOver()) {
+        ai_.ponder(engine_);
+    }
 }
 
-bool GameEngine::isValidMove(int row, int col) const
+void GameEngine::setAIThinking(bool thinking)
 {
-    return row >= 0 && row < 3 && col >= 0 && col < 3 && board_[row][col] == Player::NONE;
+    if (aiThinking_ == thinking) {
+        return;
+    }
+    aiThinking_ = thinking;
+    emit aiThinkingChanged(thinking);
 }
 
-} // namespace tictactoe 
\ No newline at end of file
+} // namespace tictactoe
@@ -0,0 +1,504 @@
+#include "game/mcts_opponent.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace tictactoe {
+
+namespace {
+
+// Prior weight of a line holding `count` stones of one side and none of the
+// other; a cell scores for the lines it extends and for the lines it blocks
+constexpr float kLineWeights[] = {1.0f, 4.0f, 16.0f, 64.0f, 256.0f, 1024.0f, 4096.0f};
+
+constexpr std::uint64_t kUnlimited = std::numeric_limits<std::uint64_t>::max();
+
+// The clock is read once per this many playouts
+constexpr std::uint64_t kClockInterval = 64;
+
+Player opponentOf(Player player)
+{
+    return (player == Player::X) ? Player::O : Player::X;
+}
+
+} // namespace
+
+template <typename Engine>
+BasicMCTSOpponent<Engine>::BasicMCTSOpponent()
+    : rule_(SelectionRule::UCT)
+    , exploration_(1.4)
+    , treeReuse_(true)
+    , maxTreeBytes_(kDefaultMaxTreeBytes)
+    , seed_(0x9E3779B97F4A7C15ULL)
+    , playoutsPerSecond_(0.0)
+{
+    setThreadCount(1);
+}
+
+template <typename Engine>
+std::pair<int, int> BasicMCTSOpponent<Engine>::calculateBestMove(const Board& board, Player aiPlayer)
+{
+    engine_.setBoard(board, aiPlayer);
+
+    // A board that already has a line leaves nothing to search; answer with
+    // the empty cell BasicAIOpponent would pick, nearest the centre
+    int cell = -1;
+    if (engine_.isGameOver()) {
+        const auto empty = static_cast<typename Engine::Mask>(
+            Engine::kFullBoard & ~(engine_.getPlayerMask(Player::X) | engine_.getPlayerMask(Player::O)));
+        for (const int candidate : BasicAIOpponent<Engine>::kRootOrder) {
+            if (hasCell(empty, candidate)) {
+                cell = candidate;
+                break;
+            }
+        }
+    } else {
+        cell = searchRoot();
+    }
+
+    if (cell < 0) {
+        return {-1, -1};
+    }
+    return {cell / Engine::kSize, cell % Engine::kSize};
+}
+
+template <typename Engine>
+int BasicMCTSOpponent<Engine>::calculateBestMove(const Engine& engine)
+{
+    if (engine.isGameOver()) {
+        return -1;
+    }
+    engine_ = engine;
+    return searchRoot();
+}
+
+template <typename Engine>
+int BasicMCTSOpponent<Engine>::searchRoot()
+{
+    const auto start = Clock::now();
+    deadline_ = start + limits_.moveTime;
+
+    std::uint64_t total = limits_.maxNodes;
+    if (total == 0 && limits_.moveTime.count() == 0) {
+        total = kDefaultPlayouts;
+    }
+
+    runOnTrees([&](Tree& tree, std::size_t index) {
+        prepareRoot(tree);
+        std::uint64_t budget = kUnlimited;
+        if (total > 0) {
+            budget = total / trees_.size() + (index < total % trees_.size() ? 1 : 0);
+        }
+        runPlayouts(tree, budget);
+    });
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    playoutsPerSecond_ = seconds > 0.0 ? static_cast<double>(getPlayoutCount()) / seconds : 0.0;
+
+    // Most visited move over all trees; results break ties
+    std::array<std::uint64_t, Engine::kCells> visits{};
+    std::array<std::uint64_t, Engine::kCells> scores{};
+    for (const Tree& tree : trees_) {
+        for (int i = 0; i < tree.root->childCount; ++i) {
+            const Node& child = tree.root->children[i];
+            visits[child.move] += child.visits;
+            scores[child.move] += child.score;
+        }
+    }
+
+    // With no playout finished, the first child has the highest prior
+    int bestMove = trees_[0].root->children[0].move;
+    for (int cell = 0; cell < Engine::kCells; ++cell) {
+        if (visits[cell] > visits[bestMove] ||
+            (visits[cell] == visits[bestMove] && scores[cell] > scores[bestMove])) {
+            bestMove = cell;
+        }
+    }
+    return bestMove;
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::prepareRoot(Tree& tree)
+{
+    // The subtree is copied into the idle arena before the active one is
+    // reset, so everything else the old tree held is dropped at once
+    const Node* reused = (treeReuse_ && tree.root != nullptr) ? findSubtree(tree) : nullptr;
+    NodeArena& target = tree.arenas[1 - tree.active];
+    target.reset();
+    Node* root = target.template create<Node>();
+    tree.reused = 0;
+    if (reused != nullptr) {
+        *root = *reused;
+        copyChildren(*root, *reused, target);
+        tree.reused = root->visits;
+    }
+    tree.arenas[tree.active].reset();
+    tree.active = 1 - tree.active;
+    tree.root = root;
+
+    tree.rootEngine = engine_;
+    tree.engine = engine_;
+    if (root->childCount < 0) {
+        expand(tree, *root);
+    }
+}
+
+template <typename Engine>
+typename BasicMCTSOpponent<Engine>::Node* BasicMCTSOpponent<Engine>::findSubtree(const Tree& tree) const
+{
+    using Mask = typename Engine::Mask;
+    const Mask oldX = tree.rootEngine.getPlayerMask(Player::X);
+    const Mask oldO = tree.rootEngine.getPlayerMask(Player::O);
+    const Mask newX = engine_.getPlayerMask(Player::X);
+    const Mask newO = engine_.getPlayerMask(Player::O);
+    if (!isEmptyMask(static_cast<Mask>(oldX & ~newX)) || !isEmptyMask(static_cast<Mask>(oldO & ~newO))) {
+        return nullptr;
+    }
+
+    // Walk the new stones down the tree, alternating sides. Stones of one
+    // side may be taken in any order: every order reaches the same position.
+    Mask addedX = static_cast<Mask>(newX & ~oldX);
+    Mask addedO = static_cast<Mask>(newO & ~oldO);
+    Player side = tree.rootEngine.getCurrentPlayer();
+    Node* node = tree.root;
+    while (!isEmptyMask(addedX) || !isEmptyMask(addedO)) {
+        Mask& added = (side == Player::X) ? addedX : addedO;
+        if (isEmptyMask(added) || node->childCount <= 0) {
+            return nullptr;
+        }
+        const int cell = popLowestCell(added);
+        Node* next = nullptr;
+        for (int i = 0; i < node->childCount; ++i) {
+            if (node->children[i].move == cell) {
+                next = &node->children[i];
+                break;
+            }
+        }
+        if (next == nullptr) {
+            return nullptr;
+        }
+        node = next;
+        side = opponentOf(side);
+    }
+    return (side == engine_.getCurrentPlayer()) ? node : nullptr;
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::copyChildren(Node& target, const Node& source, NodeArena& arena) const
+{
+    if (source.childCount <= 0) {
+        return;
+    }
+    target.children = arena.template createArray<Node>(source.childCount);
+    for (int i = 0; i < source.childCount; ++i) {
+        target.children[i] = source.children[i];
+        copyChildren(target.children[i], source.children[i], arena);
+    }
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::runPlayouts(Tree& tree, std::uint64_t budget)
+{
+    Engine& engine = tree.engine;
+    const int rootMoves = engine.getMoveCount();
+    const Player rootPlayer = engine.getCurrentPlayer();
+    const NodeArena& arena = tree.arenas[tree.active];
+    std::array<Node*, Engine::kCells + 1> path;
+
+    tree.playouts = 0;
+    while (tree.playouts < budget) {
+        if ((tree.playouts % kClockInterval == 0 && outOfTime()) ||
+            (limits_.cancel != nullptr && limits_.cancel->load(std::memory_order_relaxed))) {
+            break;
+        }
+
+        // Walk down to a leaf; a leaf is expanded on its second visit, or
+        // never once the tree has used up its memory
+        Node* node = tree.root;
+        int depth = 0;
+        path[depth++] = node;
+        while (!engine.isGameOver()) {
+            if (node->childCount < 0) {
+                if (node->visits == 0 || arena.getBytesUsed() > maxTreeBytes_) {
+                    break;
+                }
+                expand(tree, *node);
+            }
+            node = select(*node);
+            engine.makeMove(node->move);
+            path[depth++] = node;
+        }
+
+        playOut(tree);
+        const GameState result = engine.getGameState();
+        const Player winner = (result == GameState::X_WON) ? Player::X
+                            : (result == GameState::O_WON) ? Player::O
+                                                           : Player::NONE;
+        while (engine.getMoveCount() > rootMoves) {
+            engine.undoMove();
+        }
+
+        ++tree.root->visits;
+        Player mover = rootPlayer;
+        for (int i = 1; i < depth; ++i) {
+            ++path[i]->visits;
+            path[i]->score += (winner == mover) ? 2 : ((winner == Player::NONE) ? 1 : 0);
+            mover = opponentOf(mover);
+        }
+        ++tree.playouts;
+    }
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::expand(Tree& tree, Node& node) const
+{
+    static_assert(Engine::kWinLength <= 7, "kLineWeights covers lines of up to 7 cells");
+    const Engine& engine = tree.engine;
+    const Player mover = engine.getCurrentPlayer();
+    const Player other = opponentOf(mover);
+
+    auto legal = engine.getLegalMoves();
+    const int count = cellCount(legal);
+    Node* children = tree.arenas[tree.active].template createArray<Node>(count);
+
+    float total = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        const int cell = popLowestCell(legal);
+        float weight = 0.0f;
+        for (int j = 0; j < Engine::Lines::kByCell.counts[cell]; ++j) {
+            const int line = Engine::Lines::kByCell.lines[cell][j];
+            const int own = engine.getLineCount(line, mover);
+            const int theirs = engine.getLineCount(line, other);
+            if (theirs == 0) {
+                weight += kLineWeights[own];
+            }
+            if (own == 0) {
+                weight += kLineWeights[theirs];
+            }
+        }
+        children[i].move = static_cast<std::int16_t>(cell);
+        children[i].prior = weight + 1.0f;
+        total += children[i].prior;
+    }
+    for (int i = 0; i < count; ++i) {
+        children[i].prior /= total;
+    }
+
+    // Highest prior first, so UCT also tries the likeliest moves first
+    std::stable_sort(children, children + count, [](const Node& a, const Node& b) {
+        return a.prior > b.prior;
+    });
+    node.children = children;
+    node.childCount = static_cast<std::int16_t>(count);
+}
+
+template <typename Engine>
+typename BasicMCTSOpponent<Engine>::Node* BasicMCTSOpponent<Engine>::select(const Node& node) const
+{
+    Node* best = node.children;
+    double bestValue = -std::numeric_limits<double>::infinity();
+    if (rule_ == SelectionRule::UCT) {
+        const double logVisits = std::log(static_cast<double>(std::max<std::uint32_t>(node.visits, 1)));
+        for (int i = 0; i < node.childCount; ++i) {
+            Node& child = node.children[i];
+            if (child.visits == 0) {
+                return &child;
+            }
+            const double value = child.score / (2.0 * child.visits) +
+                                 exploration_ * std::sqrt(logVisits / child.visits);
+            if (value > bestValue) {
+                bestValue = value;
+                best = &child;
+            }
+        }
+        return best;
+    }
+
+    const double rootVisits = std::sqrt(static_cast<double>(node.visits));
+    for (int i = 0; i < node.childCount; ++i) {
+        Node& child = node.children[i];
+        const double mean = child.visits > 0 ? child.score / (2.0 * child.visits) : 0.5;
+        const double value = mean + exploration_ * child.prior * rootVisits / (1.0 + child.visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = &child;
+        }
+    }
+    return best;
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::playOut(Tree& tree)
+{
+    Engine& engine = tree.engine;
+    if (engine.isGameOver()) {
+        return;
+    }
+
+    // Draw from the empty cells without replacement
+    std::array<std::uint8_t, Engine::kCells> cells;
+    auto legal = engine.getLegalMoves();
+    int count = 0;
+    while (!isEmptyMask(legal)) {
+        cells[count++] = static_cast<std::uint8_t>(popLowestCell(legal));
+    }
+    while (!engine.isGameOver()) {
+        const int i = static_cast<int>(((tree.rng() >> 32) * static_cast<std::uint64_t>(count)) >> 32);
+        engine.makeMove(cells[i]);
+        cells[i] = cells[--count];
+    }
+}
+
+template <typename Engine>
+bool BasicMCTSOpponent<Engine>::outOfTime() const
+{
+    return limits_.moveTime.count() > 0 && Clock::now() >= deadline_;
+}
+
+template <typename Engine>
+template <typename Task>
+void BasicMCTSOpponent<Engine>::runOnTrees(Task&& task)
+{
+    for (std::size_t i = 1; i < trees_.size(); ++i) {
+        helpers_->submit([this, i, &task] {
+            task(trees_[i], i);
+        });
+    }
+    task(trees_[0], 0);
+    if (helpers_) {
+        helpers_->wait();
+    }
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::setSearchLimits(const SearchLimits& limits)
+{
+    limits_ = limits;
+}
+
+template <typename Engine>
+const SearchLimits& BasicMCTSOpponent<Engine>::getSearchLimits() const
+{
+    return limits_;
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::setThreadCount(unsigned threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (threadCount == trees_.size()) {
+        return;
+    }
+    trees_.resize(threadCount);
+    setSeed(seed_);
+    helpers_.reset(threadCount > 1 ? new WorkStealingPool(threadCount - 1) : nullptr);
+}
+
+template <typename Engine>
+unsigned BasicMCTSOpponent<Engine>::getThreadCount() const
+{
+    return static_cast<unsigned>(trees_.size());
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::setSelectionRule(SelectionRule rule)
+{
+    rule_ = rule;
+}
+
+template <typename Engine>
+SelectionRule BasicMCTSOpponent<Engine>::getSelectionRule() const
+{
+    return rule_;
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::setExplorationConstant(double exploration)
+{
+    exploration_ = exploration;
+}
+
+template <typename Engine>
+double BasicMCTSOpponent<Engine>::getExplorationConstant() const
+{
+    return exploration_;
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::setTreeReuse(bool enabled)
+{
+    treeReuse_ = enabled;
+}
+
+template <typename Engine>
+bool BasicMCTSOpponent<Engine>::isTreeReuseEnabled() const
+{
+    return treeReuse_;
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::setMaxTreeBytes(std::size_t bytes)
+{
+    maxTreeBytes_ = bytes;
+}
+
+template <typename Engine>
+std::size_t BasicMCTSOpponent<Engine>::getMaxTreeBytes() const
+{
+    return maxTreeBytes_;
+}
+
+template <typename Engine>
+void BasicMCTSOpponent<Engine>::setSeed(std::uint64_t seed)
+{
+    seed_ = seed;
+    for (std::size_t i = 0; i < trees_.size(); ++i) {
+        trees_[i].rng.seed(seed + i);
+    }
+}
+
+template <typename Engine>
+std::uint64_t BasicMCTSOpponent<Engine>::getPlayoutCount() const
+{
+    std::uint64_t playouts = 0;
+    for (const Tree& tree : trees_) {
+        playouts += tree.playouts;
+    }
+    return playouts;
+}
+
+template <typename Engine>
+double BasicMCTSOpponent<Engine>::getPlayoutsPerSecond() const
+{
+    return playoutsPerSecond_;
+}
+
+template <typename Engine>
+std::uint64_t BasicMCTSOpponent<Engine>::getReusedPlayouts() const
+{
+    std::uint64_t reused = 0;
+    for (const Tree& tree : trees_) {
+        reused += tree.reused;
+    }
+    return reused;
+}
+
+template <typename Engine>
+std::size_t BasicMCTSOpponent<Engine>::getTreeBytes() const
+{
+    std::size_t bytes = 0;
+    for (const Tree& tree : trees_) {
+        bytes += tree.arenas[tree.active].getBytesUsed();
+    }
+    return bytes;
+}
+
+template class BasicMCTSOpponent<ClassicGameEngine>;
+template class BasicMCTSOpponent<GameEngine4x4>;
+template class BasicMCTSOpponent<GameEngine5x5>;
+template class BasicMCTSOpponent<GomokuEngine>;
+
+} // namespace tictactoe
@@ -0,0 +1,43 @@
+#include "game/move_delta_batcher.h"
+#include <QMetaObject>
+
+namespace tictactoe {
+
+MoveDeltaBatcher::MoveDeltaBatcher(GameEngine* engine, QObject* parent)
+    : QObject(parent)
+    , flushScheduled_(false)
+{
+    connect(engine, &GameEngine::moveApplied,
+            this, &MoveDeltaBatcher::onMoveApplied);
+    connect(engine, &GameEngine::gameReset,
+            this, &MoveDeltaBatcher::onGameReset);
+}
+
+void MoveDeltaBatcher::onMoveApplied(const MoveDelta& delta)
+{
+    pending_.append(delta);
+    if (!flushScheduled_) {
+        flushScheduled_ = true;
+        QMetaObject::invokeMethod(this, &MoveDeltaBatcher::flush, Qt::QueuedConnection);
+    }
+}
+
+void MoveDeltaBatcher::onGameReset()
+{
+    // Moves from the previous game are obsolete; listeners redraw on reset
+    pending_.clear();
+}
+
+void MoveDeltaBatcher::flush()
+{
+    flushScheduled_ = false;
+    if (pending_.isEmpty()) {
+        return;
+    }
+
+    QVector<MoveDelta> deltas;
+    deltas.swap(pending_);
+    emit movesApplied(deltas);
+}
+
+} // namespace tictactoe
@@ -0,0 +1,62 @@
+#include "game/node_arena.h"
+#include <algorithm>
+
+namespace tictactoe {
+
+NodeArena::NodeArena(std::size_t blockSize)
+    : blockSize_(std::max<std::size_t>(blockSize, 64))
+    , current_(0)
+    , offset_(0)
+    , used_(0)
+{
+}
+
+void* NodeArena::allocate(std::size_t size, std::size_t alignment)
+{
+    // Keep the current block while the request fits, then move on to the
+    // next kept block, adding a new one only past the last
+    while (current_ < blocks_.size()) {
+        Block& block = blocks_[current_];
+        const std::size_t start = (offset_ + alignment - 1) & ~(alignment - 1);
+        if (start + size <= block.size) {
+            offset_ = start + size;
+            used_ += size;
+            return block.data.get() + start;
+        }
+        ++current_;
+        offset_ = 0;
+    }
+
+    // new[] storage is aligned for any fundamental type
+    Block block;
+    block.size = std::max(blockSize_, size);
+    block.data.reset(new unsigned char[block.size]);
+    blocks_.push_back(std::move(block));
+    current_ = blocks_.size() - 1;
+    offset_ = size;
+    used_ += size;
+    return blocks_.back().data.get();
+}
+
+void NodeArena::reset()
+{
+    current_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+std::size_t NodeArena::getBytesUsed() const
+{
+    return used_;
+}
+
+std::size_t NodeArena::getBytesReserved() const
+{
+    std::size_t reserved = 0;
+    for (const Block& block : blocks_) {
+        reserved += block.size;
+    }
+    return reserved;
+}
+
+} // namespace tictactoe
@@ -0,0 +1,405 @@
+#include "game/proof_solver.h"
+#include <algorithm>
+#include <utility>
+
+namespace tictactoe {
+
+namespace {
+
+// Keys of proofs for O differ from those for X, so both share one table
+constexpr std::uint64_t kAttackerOKey = detail::splitMix64(0x70726F6F66ull);
+
+std::uint32_t addNumbers(std::uint32_t a, std::uint32_t b, std::uint32_t infinity)
+{
+    return (a >= infinity - b) ? infinity : a + b;
+}
+
+template <typename Engine>
+std::array<int, Engine::kCells> makeProofMoveOrder()
+{
+    std::array<int, Engine::kCells> order;
+    for (int cell = 0; cell < Engine::kCells; ++cell) {
+        order[cell] = cell;
+    }
+    std::stable_sort(order.begin(), order.end(), [](int a, int b) {
+        return Engine::Lines::kByCell.counts[a] > Engine::Lines::kByCell.counts[b];
+    });
+    return order;
+}
+
+Player opponentOf(Player player)
+{
+    return (player == Player::X) ? Player::O : Player::X;
+}
+
+} // namespace
+
+template <typename Engine>
+const std::array<int, Engine::kCells> BasicProofSolver<Engine>::kMoveOrder = makeProofMoveOrder<Engine>();
+
+template <typename Engine>
+BasicProofSolver<Engine>::BasicProofSolver(std::size_t tableBytes)
+    : bucketMask_(0)
+    , tableUsage_(0)
+    , progressInterval_(kDefaultProgressInterval)
+    , nextProgress_(0)
+    , nodes_(0)
+    , nextClockCheck_(0)
+    , stopped_(false)
+    , attacker_(Player::X)
+    , attackerKey_(0)
+    , rootAttacks_(true)
+    , rootPhi_(1)
+    , rootDelta_(1)
+    , provenMove_(-1)
+{
+    // A power of two of whole buckets, so a key picks its bucket by mask
+    std::size_t buckets = 1;
+    while (buckets * 2 * kBucketSize * sizeof(Entry) <= tableBytes) {
+        buckets *= 2;
+    }
+    table_.resize(buckets * kBucketSize);
+    bucketMask_ = buckets - 1;
+}
+
+template <typename Engine>
+ProofResult BasicProofSolver<Engine>::prove(const Engine& engine, Player attacker)
+{
+    engine_ = engine;
+    nodes_ = 0;
+    nextProgress_ = progressInterval_;
+    nextClockCheck_ = 0;
+    stopped_ = false;
+    start_ = Clock::now();
+    deadline_ = start_ + limits_.moveTime;
+    return proveFrom(attacker);
+}
+
+template <typename Engine>
+Outcome BasicProofSolver<Engine>::solve(const Engine& engine)
+{
+    const Player mover = engine.getCurrentPlayer();
+    switch (engine.getGameState()) {
+        case GameState::IN_PROGRESS:
+            break;
+        case GameState::DRAW:
+            provenMove_ = -1;
+            return Outcome::DRAW;
+        default:
+            provenMove_ = -1;
+            return Outcome::LOSS;
+    }
+
+    const ProofResult win = prove(engine, mover);
+    if (win != ProofResult::DISPROVEN) {
+        return (win == ProofResult::PROVEN) ? Outcome::WIN : Outcome::UNKNOWN;
+    }
+    // The node count and the clock run on over the second proof
+    switch (proveFrom(opponentOf(mover))) {
+        case ProofResult::PROVEN:
+            return Outcome::LOSS;
+        case ProofResult::DISPROVEN:
+            return Outcome::DRAW;
+        case ProofResult::UNKNOWN:
+            break;
+    }
+    return Outcome::UNKNOWN;
+}
+
+template <typename Engine>
+int BasicProofSolver<Engine>::getProvenMove() const
+{
+    return provenMove_;
+}
+
+template <typename Engine>
+void BasicProofSolver<Engine>::setSearchLimits(const SearchLimits& limits)
+{
+    limits_ = limits;
+}
+
+template <typename Engine>
+const SearchLimits& BasicProofSolver<Engine>::getSearchLimits() const
+{
+    return limits_;
+}
+
+template <typename Engine>
+void BasicProofSolver<Engine>::setProgressCallback(ProgressCallback callback, std::uint64_t intervalNodes)
+{
+    progressCallback_ = std::move(callback);
+    progressInterval_ = std::max<std::uint64_t>(intervalNodes, 1);
+}
+
+template <typename Engine>
+std::uint64_t BasicProofSolver<Engine>::getNodeCount() const
+{
+    return nodes_;
+}
+
+template <typename Engine>
+std::size_t BasicProofSolver<Engine>::getTableCapacity() const
+{
+    return table_.size();
+}
+
+template <typename Engine>
+std::size_t BasicProofSolver<Engine>::getTableUsage() const
+{
+    return tableUsage_;
+}
+
+template <typename Engine>
+void BasicProofSolver<Engine>::clearTable()
+{
+    std::fill(table_.begin(), table_.end(), Entry{});
+    tableUsage_ = 0;
+}
+
+template <typename Engine>
+ProofResult BasicProofSolver<Engine>::proveFrom(Player attacker)
+{
+    attacker_ = attacker;
+    attackerKey_ = (attacker == Player::O) ? kAttackerOKey : 0;
+    rootPhi_ = 1;
+    rootDelta_ = 1;
+    provenMove_ = -1;
+
+    const Player mover = engine_.getCurrentPlayer();
+    rootAttacks_ = (mover == attacker);
+    if (engine_.getGameState() == GameState::IN_PROGRESS) {
+        std::uint32_t phi = 0;
+        std::uint32_t delta = 0;
+        search(engine_.getZobristKey() ^ attackerKey_, mover, 0, kInfinity, kInfinity, phi, delta);
+    } else {
+        const bool attackerWon = engine_.getGameState() ==
+                                 ((attacker == Player::X) ? GameState::X_WON : GameState::O_WON);
+        rootPhi_ = (attackerWon == rootAttacks_) ? 0 : kInfinity;
+        rootDelta_ = (attackerWon == rootAttacks_) ? kInfinity : 0;
+    }
+    if (progressCallback_) {
+        reportProgress();
+    }
+
+    // Root numbers are the mover's; the result is the attacker's
+    const std::uint32_t proof = rootAttacks_ ? rootPhi_ : rootDelta_;
+    const std::uint32_t disproof = rootAttacks_ ? rootDelta_ : rootPhi_;
+    if (proof == 0) {
+        return ProofResult::PROVEN;
+    }
+    return (disproof == 0) ? ProofResult::DISPROVEN : ProofResult::UNKNOWN;
+}
+
+template <typename Engine>
+void BasicProofSolver<Engine>::search(std::uint64_t key, Player mover, int ply, std::uint32_t thresholdPhi,
+                                      std::uint32_t thresholdDelta, std::uint32_t& phi, std::uint32_t& delta)
+{
+    ++nodes_;
+    const std::uint64_t startNodes = nodes_;
+    if (progressCallback_ && nodes_ >= nextProgress_) {
+        nextProgress_ = nodes_ + progressInterval_;
+        reportProgress();
+    }
+
+    Mask moves{};
+    int goalMove = -1;
+    if (evaluateLeaf(mover, phi, delta, moves, goalMove)) {
+        store(key, phi, delta, 1);
+        if (ply == 0) {
+            rootPhi_ = phi;
+            rootDelta_ = delta;
+            provenMove_ = (phi == 0) ? goalMove : -1;
+        }
+        return;
+    }
+
+    // Children by key: a stone of the mover, and the other side to move.
+    // Their numbers are read from the table once and then kept here, so a
+    // child evicted while this node is open does not lose its progress.
+    const int side = (mover == Player::O) ? 1 : 0;
+    std::array<int, Engine::kCells> cells;
+    std::array<std::uint64_t, Engine::kCells> childKeys;
+    std::array<std::uint32_t, Engine::kCells> childPhis;
+    std::array<std::uint32_t, Engine::kCells> childDeltas;
+    int count = 0;
+    for (const int cell : kMoveOrder) {
+        if (hasCell(moves, cell)) {
+            cells[count] = cell;
+            childKeys[count] = key ^ Engine::Zobrist::kPieces[cell][side] ^ Engine::Zobrist::kOToMove;
+            lookup(childKeys[count], childPhis[count], childDeltas[count]);
+            ++count;
+        }
+    }
+
+    const Player next = opponentOf(mover);
+    while (true) {
+        // The mover needs one child the opponent fails in, and is refuted
+        // only if the opponent succeeds in all of them
+        int best = 0;
+        std::uint32_t secondDelta = kInfinity;
+        std::uint32_t sumPhi = 0;
+        for (int i = 0; i < count; ++i) {
+            sumPhi = addNumbers(sumPhi, childPhis[i], kInfinity);
+            if (childDeltas[i] < childDeltas[best]) {
+                secondDelta = childDeltas[best];
+                best = i;
+            } else if (i != best && childDeltas[i] < secondDelta) {
+                secondDelta = childDeltas[i];
+            }
+        }
+        phi = childDeltas[best];
+        delta = sumPhi;
+        if (ply == 0) {
+            rootPhi_ = phi;
+            rootDelta_ = delta;
+            provenMove_ = (phi == 0) ? cells[best] : -1;
+        }
+        if (phi >= thresholdPhi || delta >= thresholdDelta || stopped_ || outOfBudget()) {
+            break;
+        }
+
+        // Search the most proving child until it stops being that, or its
+        // sum pushes this node past its threshold
+        const std::uint32_t childThresholdPhi = addNumbers(thresholdDelta - delta, childPhis[best], kInfinity);
+        const std::uint32_t childThresholdDelta = std::min(thresholdPhi, addNumbers(secondDelta, 1, kInfinity));
+        engine_.makeMove(cells[best]);
+        search(childKeys[best], next, ply + 1, childThresholdPhi, childThresholdDelta, childPhis[best],
+               childDeltas[best]);
+        engine_.undoMove();
+    }
+    store(key, phi, delta, nodes_ - startNodes + 1);
+}
+
+template <typename Engine>
+bool BasicProofSolver<Engine>::evaluateLeaf(Player mover, std::uint32_t& phi, std::uint32_t& delta,
+                                            Mask& children, int& move) const
+{
+    const bool attacking = (mover == attacker_);
+    auto settle = [&](bool reached) {
+        phi = reached ? 0 : kInfinity;
+        delta = reached ? kInfinity : 0;
+        return true;
+    };
+
+    // The engine keeps the last mover to play once the game is over
+    switch (engine_.getGameState()) {
+        case GameState::IN_PROGRESS:
+            break;
+        case GameState::DRAW:
+            return settle(!attacking);
+        default:
+            return settle(false);
+    }
+
+    const Mask own = engine_.getThreats(mover);
+    if (!isEmptyMask(own)) {
+        move = lowestCell(own);
+        return settle(true);
+    }
+    const Mask theirs = engine_.getThreats(opponentOf(mover));
+    const int blocks = cellCount(theirs);
+    if (blocks > 1) {
+        return settle(false);
+    }
+
+    // Open lines: no stone of one side. A cell on none of them is a pass,
+    // which never helps either side in K-in-a-row.
+    const Player defender = opponentOf(attacker_);
+    bool attackerOpen = false;
+    Mask live{};
+    for (int line = 0; line < Engine::Lines::kCount; ++line) {
+        const bool noDefender = engine_.getLineCount(line, defender) == 0;
+        if (noDefender || engine_.getLineCount(line, attacker_) == 0) {
+            live |= Engine::Lines::kMasks[line];
+            attackerOpen = attackerOpen || noDefender;
+        }
+    }
+    const Mask legal = engine_.getLegalMoves();
+    if (!attackerOpen) {
+        move = lowestCell(legal);
+        return settle(!attacking);
+    }
+
+    // A single threat must be blocked at once
+    children = (blocks == 1) ? theirs : static_cast<Mask>(legal & live);
+    return false;
+}
+
+template <typename Engine>
+void BasicProofSolver<Engine>::lookup(std::uint64_t key, std::uint32_t& phi, std::uint32_t& delta) const
+{
+    const Entry* bucket = &table_[(key & bucketMask_) * kBucketSize];
+    for (std::size_t i = 0; i < kBucketSize; ++i) {
+        if (bucket[i].key == key && bucket[i].work != 0) {
+            phi = bucket[i].phi;
+            delta = bucket[i].delta;
+            return;
+        }
+    }
+    phi = 1;
+    delta = 1;
+}
+
+template <typename Engine>
+void BasicProofSolver<Engine>::store(std::uint64_t key, std::uint32_t phi, std::uint32_t delta, std::uint64_t work)
+{
+    // The key's own slot, else the one that was cheapest to fill; an empty
+    // slot has no work at all
+    Entry* bucket = &table_[(key & bucketMask_) * kBucketSize];
+    Entry* slot = &bucket[0];
+    for (std::size_t i = 0; i < kBucketSize; ++i) {
+        if (bucket[i].key == key && bucket[i].work != 0) {
+            slot = &bucket[i];
+            work += slot->work;
+            break;
+        }
+        if (bucket[i].work < slot->work) {
+            slot = &bucket[i];
+        }
+    }
+    if (slot->work == 0) {
+        ++tableUsage_;
+    }
+    slot->key = key;
+    slot->phi = phi;
+    slot->delta = delta;
+    slot->work = work;
+}
+
+template <typename Engine>
+bool BasicProofSolver<Engine>::outOfBudget()
+{
+    // Reading the clock costs more than a node, so it is only read every
+    // 256 nodes
+    bool exhausted = (limits_.maxNodes != 0 && nodes_ >= limits_.maxNodes) ||
+                     (limits_.cancel != nullptr && limits_.cancel->load(std::memory_order_relaxed));
+    if (!exhausted && limits_.moveTime.count() != 0 && nodes_ >= nextClockCheck_) {
+        nextClockCheck_ = nodes_ + 256;
+        exhausted = Clock::now() >= deadline_;
+    }
+    stopped_ = stopped_ || exhausted;
+    return exhausted;
+}
+
+template <typename Engine>
+void BasicProofSolver<Engine>::reportProgress()
+{
+    ProofProgress progress;
+    progress.attacker = attacker_;
+    progress.proofNumber = rootAttacks_ ? rootPhi_ : rootDelta_;
+    progress.disproofNumber = rootAttacks_ ? rootDelta_ : rootPhi_;
+    progress.nodes = nodes_;
+    progress.tableEntries = tableUsage_;
+    progress.tableCapacity = table_.size();
+    progress.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start_);
+    progressCallback_(progress);
+}
+
+template class BasicProofSolver<ClassicGameEngine>;
+template class BasicProofSolver<GameEngine4x4>;
+template class BasicProofSolver<GameEngine5x5>;
+template class BasicProofSolver<GameEngine6x6>;
+template class BasicProofSolver<GomokuEngine>;
+template class BasicProofSolver<QubicEngine>;
+
+} // namespace tictactoe
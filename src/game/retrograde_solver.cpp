@@ -0,0 +1,295 @@
+#include "game/retrograde_solver.h"
+#include "concurrency/work_stealing_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace tictactoe {
+
+namespace {
+
+// Occupied-cell masks handed to one task
+constexpr std::size_t kMasksPerTask = 64;
+
+// Base-3 rank of the cells in an 8-bit mask, each counting as digit 1
+constexpr std::array<std::uint32_t, 256> makeByteRanks()
+{
+    std::array<std::uint32_t, 256> ranks{};
+    for (int byte = 0; byte < 256; ++byte) {
+        std::uint32_t power = 1;
+        for (int bit = 0; bit < 8; ++bit, power *= 3) {
+            ranks[byte] += ((byte >> bit) & 1) ? power : 0;
+        }
+    }
+    return ranks;
+}
+
+constexpr std::array<std::uint32_t, 256> kByteRanks = makeByteRanks();
+
+// Position index of a board with cells up to 16: X cells count 1, O cells 2
+std::uint64_t rankOf(std::uint32_t x, std::uint32_t o)
+{
+    const std::uint64_t xRank = kByteRanks[x & 0xFF] + std::uint64_t{6561} * kByteRanks[x >> 8];
+    const std::uint64_t oRank = kByteRanks[o & 0xFF] + std::uint64_t{6561} * kByteRanks[o >> 8];
+    return xRank + 2 * oRank;
+}
+
+Outcome readOutcome(const std::atomic<std::uint64_t>* words, std::uint64_t index)
+{
+    const std::uint64_t word = words[index / 32].load(std::memory_order_relaxed);
+    return static_cast<Outcome>((word >> (2 * (index % 32))) & 3u);
+}
+
+template <typename Engine>
+bool hasLine(std::uint32_t stones)
+{
+    for (const auto line : Engine::Lines::kMasks) {
+        if ((stones & line) == line) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Value of a position with no line from its children one stone up: a win
+// if one is lost for the opponent, else a draw if one is drawn or the board
+// is full
+template <typename Engine>
+Outcome solveChildren(const std::atomic<std::uint64_t>* words, std::uint64_t index, std::uint32_t empty,
+                      std::uint64_t moverDigit)
+{
+    constexpr auto& kPowers = PositionIndex<Engine::kCells>::kPowers;
+    Outcome outcome = (empty == 0) ? Outcome::DRAW : Outcome::LOSS;
+    for (std::uint32_t rest = empty; rest != 0; rest &= rest - 1) {
+        const Outcome child = readOutcome(words, index + kPowers[lowestBit64(rest)] * moverDigit);
+        if (child == Outcome::LOSS) {
+            return Outcome::WIN;
+        }
+        if (child == Outcome::DRAW) {
+            outcome = Outcome::DRAW;
+        }
+    }
+    return outcome;
+}
+
+// Value every position with `level` stones whose occupied cells are one of
+// `occupied`. Children, one stone up, are already in `words`.
+template <typename Engine>
+void solveMasks(const std::uint32_t* occupied, std::size_t count, int level, std::atomic<std::uint64_t>* words)
+{
+    const int xCount = (level + 1) / 2;
+    const bool xToMove = (level % 2) == 0;
+    const std::uint64_t moverDigit = xToMove ? 1 : 2;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint32_t stones = occupied[i];
+        const std::uint32_t empty = static_cast<std::uint32_t>(Engine::kFullBoard) & ~stones;
+
+        // Every way to split the stones with X holding xCount of them
+        for (std::uint32_t x = stones;; x = (x - 1) & stones) {
+            if (popCount64(x) == xCount) {
+                const std::uint32_t o = stones & ~x;
+                const std::uint32_t mover = xToMove ? x : o;
+                const std::uint32_t waiting = xToMove ? o : x;
+                const std::uint64_t index = rankOf(x, o);
+
+                // A line for the side to move is never reached in play, so
+                // that position stays UNKNOWN
+                Outcome outcome = Outcome::UNKNOWN;
+                if (!hasLine<Engine>(mover)) {
+                    outcome = hasLine<Engine>(waiting) ? Outcome::LOSS : solveChildren<Engine>(words, index, empty, moverDigit);
+                }
+                if (outcome != Outcome::UNKNOWN) {
+                    words[index / 32].fetch_or(static_cast<std::uint64_t>(outcome) << (2 * (index % 32)),
+                                               std::memory_order_relaxed);
+                }
+            }
+            if (x == 0) {
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+template <typename Engine>
+OutcomeTable<Engine>::OutcomeTable(std::vector<std::uint64_t> words)
+    : owned_(std::move(words))
+{
+}
+
+template <typename Engine>
+bool OutcomeTable<Engine>::isLoaded() const
+{
+    return words() != nullptr;
+}
+
+template <typename Engine>
+bool OutcomeTable<Engine>::isMapped() const
+{
+    return tablebase_ && tablebase_->isMapped();
+}
+
+template <typename Engine>
+const std::uint64_t* OutcomeTable<Engine>::words() const
+{
+    if (tablebase_) {
+        return tablebase_->getWords();
+    }
+    return owned_.empty() ? nullptr : owned_.data();
+}
+
+template <typename Engine>
+Outcome OutcomeTable<Engine>::get(std::uint64_t positionIndex) const
+{
+    const std::uint64_t* packed = words();
+    if (positionIndex >= kPositions || packed == nullptr) {
+        return Outcome::UNKNOWN;
+    }
+    return static_cast<Outcome>((packed[positionIndex / kPerWord] >> (2 * (positionIndex % kPerWord))) & 3u);
+}
+
+template <typename Engine>
+Outcome OutcomeTable<Engine>::lookup(const Engine& engine) const
+{
+    // The index does not say whose turn it is; only the turn the stone
+    // counts imply is in the table
+    const int xCount = cellCount(engine.getPlayerMask(Player::X));
+    const int oCount = cellCount(engine.getPlayerMask(Player::O));
+    if (xCount != oCount + (engine.getCurrentPlayer() == Player::O ? 1 : 0)) {
+        return Outcome::UNKNOWN;
+    }
+    return get(engine.getPositionIndex());
+}
+
+template <typename Engine>
+int OutcomeTable<Engine>::bestMove(Engine& engine, const std::array<int, Engine::kCells>& order) const
+{
+    if (engine.isGameOver() || lookup(engine) == Outcome::UNKNOWN) {
+        return -1;
+    }
+
+    // Any move into a lost position wins in the end, as every later
+    // position on the way is in the table too
+    int winning = -1;
+    int drawing = -1;
+    const auto legal = engine.getLegalMoves();
+    for (const int cell : order) {
+        if (!hasCell(legal, cell)) {
+            continue;
+        }
+        engine.makeMove(cell);
+        const GameState state = engine.getGameState();
+        const Outcome child = (state == GameState::IN_PROGRESS) ? lookup(engine) : Outcome::UNKNOWN;
+        engine.undoMove();
+
+        if (state == GameState::X_WON || state == GameState::O_WON) {
+            return cell;
+        }
+        if (child == Outcome::LOSS && winning < 0) {
+            winning = cell;
+        }
+        if ((child == Outcome::DRAW || state == GameState::DRAW) && drawing < 0) {
+            drawing = cell;
+        }
+    }
+    return (winning >= 0) ? winning : drawing;
+}
+
+template <typename Engine>
+std::vector<std::uint64_t> OutcomeTable<Engine>::countOutcomes() const
+{
+    std::vector<std::uint64_t> counts(4, 0);
+    for (std::uint64_t index = 0; index < kPositions && isLoaded(); ++index) {
+        ++counts[static_cast<int>(get(index))];
+    }
+    return counts;
+}
+
+template <typename Engine>
+bool OutcomeTable<Engine>::save(const std::string& path) const
+{
+    if (!isLoaded()) {
+        return false;
+    }
+    return Tablebase::write(path, describe(), words(), (kPositions + kPerWord - 1) / kPerWord);
+}
+
+template <typename Engine>
+bool OutcomeTable<Engine>::load(const std::string& path, Tablebase::Verify verify)
+{
+    owned_.clear();
+    tablebase_.reset();
+
+    auto tablebase = std::make_shared<Tablebase>();
+    if (!tablebase->open(path, verify)) {
+        return false;
+    }
+    const TablebaseInfo& info = tablebase->getInfo();
+    const TablebaseInfo expected = describe();
+    if (info.cells != expected.cells || info.winLength != expected.winLength ||
+        info.dimensions != expected.dimensions || info.bitsPerEntry != expected.bitsPerEntry ||
+        info.index != expected.index || info.entries != expected.entries) {
+        return false;
+    }
+    tablebase_ = std::move(tablebase);
+    return true;
+}
+
+template <typename Engine>
+TablebaseInfo OutcomeTable<Engine>::describe()
+{
+    TablebaseInfo info;
+    info.cells = Engine::kCells;
+    info.winLength = Engine::kWinLength;
+    info.dimensions = Engine::kDimensions;
+    info.bitsPerEntry = 2;
+    info.index = TablebaseIndex::POSITION_RANK;
+    info.entries = kPositions;
+    return info;
+}
+
+template <typename Engine>
+OutcomeTable<Engine> RetrogradeSolver<Engine>::solve(unsigned threadCount)
+{
+    constexpr int kCells = Engine::kCells;
+    const std::size_t wordCount = (OutcomeTable<Engine>::kPositions + 31) / 32;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> words(new std::atomic<std::uint64_t>[wordCount]);
+    for (std::size_t i = 0; i < wordCount; ++i) {
+        words[i].store(0, std::memory_order_relaxed);
+    }
+
+    // Occupied-cell masks grouped by stone count
+    std::vector<std::vector<std::uint32_t>> byLevel(kCells + 1);
+    for (std::uint32_t stones = 0; stones < (std::uint32_t{1} << kCells); ++stones) {
+        byLevel[popCount64(stones)].push_back(stones);
+    }
+
+    // A level only reads the one above it, which wait() has finished
+    WorkStealingPool pool(threadCount);
+    for (int level = kCells; level >= 0; --level) {
+        const std::vector<std::uint32_t>& masks = byLevel[level];
+        for (std::size_t start = 0; start < masks.size(); start += kMasksPerTask) {
+            const std::size_t count = std::min(kMasksPerTask, masks.size() - start);
+            pool.submit([&masks, &words, start, count, level] {
+                solveMasks<Engine>(masks.data() + start, count, level, words.get());
+            });
+        }
+        pool.wait();
+    }
+
+    std::vector<std::uint64_t> packed(wordCount);
+    for (std::size_t i = 0; i < wordCount; ++i) {
+        packed[i] = words[i].load(std::memory_order_relaxed);
+    }
+    return OutcomeTable<Engine>(std::move(packed));
+}
+
+template class OutcomeTable<ClassicGameEngine>;
+template class OutcomeTable<GameEngine4x4>;
+template class RetrogradeSolver<ClassicGameEngine>;
+template class RetrogradeSolver<GameEngine4x4>;
+
+} // namespace tictactoe
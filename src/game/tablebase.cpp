@@ -0,0 +1,349 @@
+#include "game/tablebase.h"
+#include "game/zobrist.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TICTACTOE_HAVE_MMAP
+#endif
+
+namespace tictactoe {
+
+namespace {
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t cells;
+    std::uint32_t winLength;
+    std::uint32_t dimensions;
+    std::uint32_t bitsPerEntry;
+    std::uint32_t index;
+    std::uint32_t headerChecksum;   // low half of the checksum of the header with this field 0
+    std::uint64_t entries;
+    std::uint64_t payloadBytes;
+    std::uint64_t payloadChecksum;
+};
+static_assert(sizeof(FileHeader) == Tablebase::kHeaderBytes, "the header is written as is");
+
+constexpr char kMagic[8] = {'T', 'T', 'T', 'B', 'A', 'S', 'E', '\0'};
+constexpr std::uint32_t kByteOrderMark = 0x01020304u;
+constexpr std::uint32_t kSwappedByteOrderMark = 0x04030201u;
+
+std::uint64_t checksum(const std::uint64_t* words, std::size_t count)
+{
+    std::uint64_t hash = 0x7461626C65626173ull;
+    for (std::size_t i = 0; i < count; ++i) {
+        hash = detail::splitMix64(hash ^ words[i]);
+    }
+    return hash;
+}
+
+std::uint32_t headerChecksum(FileHeader header)
+{
+    header.headerChecksum = 0;
+    std::uint64_t words[sizeof(FileHeader) / 8];
+    std::memcpy(words, &header, sizeof(header));
+    return static_cast<std::uint32_t>(checksum(words, sizeof(FileHeader) / 8));
+}
+
+std::uint64_t payloadBytesFor(const TablebaseInfo& info)
+{
+    const std::uint64_t bits = info.entries * info.bitsPerEntry;
+    return (bits + 63) / 64 * 8;
+}
+
+enum class MapResult {
+    MAPPED,
+    UNMAPPED,      // the file opened but cannot be mapped; read it instead
+    OPEN_FAILED
+};
+
+// Map the whole file read-only and shared, so processes share its pages
+MapResult mapFile(const std::string& path, void*& data, std::size_t& bytes)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return MapResult::OPEN_FAILED;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return MapResult::UNMAPPED;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        return MapResult::UNMAPPED;
+    }
+    // The view keeps the mapping alive once its handle is closed
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) {
+        return MapResult::UNMAPPED;
+    }
+    bytes = static_cast<std::size_t>(size.QuadPart);
+    return MapResult::MAPPED;
+#elif defined(TICTACTOE_HAVE_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return MapResult::OPEN_FAILED;
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || status.st_size <= 0) {
+        ::close(fd);
+        return MapResult::UNMAPPED;
+    }
+    void* mapped = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return MapResult::UNMAPPED;
+    }
+    // Lookups jump around the table; read-ahead would only waste memory
+    ::madvise(mapped, static_cast<std::size_t>(status.st_size), MADV_RANDOM);
+    data = mapped;
+    bytes = static_cast<std::size_t>(status.st_size);
+    return MapResult::MAPPED;
+#else
+    (void)data;
+    (void)bytes;
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return MapResult::OPEN_FAILED;
+    }
+    std::fclose(file);
+    return MapResult::UNMAPPED;
+#endif
+}
+
+void unmapFile(void* data, std::size_t bytes)
+{
+#if defined(_WIN32)
+    (void)bytes;
+    UnmapViewOfFile(data);
+#elif defined(TICTACTOE_HAVE_MMAP)
+    ::munmap(data, bytes);
+#else
+    (void)data;
+    (void)bytes;
+#endif
+}
+
+} // namespace
+
+Tablebase::~Tablebase()
+{
+    close();
+}
+
+bool Tablebase::open(const std::string& path, Verify verify)
+{
+    close();
+
+    void* data = nullptr;
+    std::size_t bytes = 0;
+    const MapResult mapped = mapFile(path, data, bytes);
+    if (mapped == MapResult::OPEN_FAILED) {
+        return fail(TablebaseError::OPEN_FAILED);
+    }
+
+    FileHeader header;
+    std::FILE* file = nullptr;
+    if (mapped == MapResult::MAPPED) {
+        mapping_ = data;
+        mappingBytes_ = bytes;
+        if (bytes < sizeof(header)) {
+            return fail(TablebaseError::SIZE_MISMATCH);
+        }
+        std::memcpy(&header, data, sizeof(header));
+    } else {
+        file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            return fail(TablebaseError::OPEN_FAILED);
+        }
+        if (std::fread(&header, sizeof(header), 1, file) != 1) {
+            std::fclose(file);
+            return fail(TablebaseError::SIZE_MISMATCH);
+        }
+    }
+
+    TablebaseError error = TablebaseError::NONE;
+    info_.cells = header.cells;
+    info_.winLength = header.winLength;
+    info_.dimensions = header.dimensions;
+    info_.bitsPerEntry = header.bitsPerEntry;
+    info_.index = static_cast<TablebaseIndex>(header.index);
+    info_.entries = header.entries;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        error = TablebaseError::BAD_MAGIC;
+    } else if (header.byteOrder == kSwappedByteOrderMark) {
+        error = TablebaseError::WRONG_BYTE_ORDER;
+    } else if (header.byteOrder != kByteOrderMark || header.headerChecksum != headerChecksum(header)) {
+        error = TablebaseError::BAD_HEADER;
+    } else if (header.version == 0 || header.version > kVersion) {
+        error = TablebaseError::BAD_VERSION;
+    } else if (header.bitsPerEntry == 0 || header.bitsPerEntry > 64 ||
+               header.index != static_cast<std::uint32_t>(TablebaseIndex::POSITION_RANK) ||
+               header.payloadBytes != payloadBytesFor(info_)) {
+        error = TablebaseError::BAD_HEADER;
+    }
+    payloadChecksum_ = header.payloadChecksum;
+    wordCount_ = static_cast<std::size_t>(header.payloadBytes / 8);
+
+    if (error == TablebaseError::NONE) {
+        if (file == nullptr) {
+            if (mappingBytes_ != sizeof(header) + header.payloadBytes) {
+                error = TablebaseError::SIZE_MISMATCH;
+            } else {
+                words_ = reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(mapping_) + sizeof(header));
+            }
+        } else {
+            copy_.resize(wordCount_);
+            if (std::fread(copy_.data(), sizeof(std::uint64_t), wordCount_, file) != wordCount_ ||
+                std::fgetc(file) != EOF) {
+                error = TablebaseError::SIZE_MISMATCH;
+            } else {
+                words_ = copy_.data();
+            }
+        }
+    }
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+    if (error == TablebaseError::NONE && verify == Verify::FULL && !this->verify()) {
+        error = TablebaseError::BAD_CHECKSUM;
+    }
+    if (error != TablebaseError::NONE) {
+        return fail(error);
+    }
+    error_ = TablebaseError::NONE;
+    return true;
+}
+
+void Tablebase::close()
+{
+    if (mapping_ != nullptr) {
+        unmapFile(mapping_, mappingBytes_);
+    }
+    mapping_ = nullptr;
+    mappingBytes_ = 0;
+    copy_.clear();
+    copy_.shrink_to_fit();
+    words_ = nullptr;
+    wordCount_ = 0;
+    info_ = TablebaseInfo{};
+    payloadChecksum_ = 0;
+}
+
+bool Tablebase::isOpen() const
+{
+    return words_ != nullptr;
+}
+
+bool Tablebase::isMapped() const
+{
+    return words_ != nullptr && mapping_ != nullptr;
+}
+
+TablebaseError Tablebase::getError() const
+{
+    return error_;
+}
+
+const TablebaseInfo& Tablebase::getInfo() const
+{
+    return info_;
+}
+
+const std::uint64_t* Tablebase::getWords() const
+{
+    return words_;
+}
+
+std::size_t Tablebase::getWordCount() const
+{
+    return wordCount_;
+}
+
+bool Tablebase::verify() const
+{
+    return words_ != nullptr && checksum(words_, wordCount_) == payloadChecksum_;
+}
+
+bool Tablebase::write(const std::string& path, const TablebaseInfo& info,
+                      const std::uint64_t* words, std::size_t wordCount)
+{
+    if (info.bitsPerEntry == 0 || info.bitsPerEntry > 64 || payloadBytesFor(info) != wordCount * 8) {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.cells = info.cells;
+    header.winLength = info.winLength;
+    header.dimensions = info.dimensions;
+    header.bitsPerEntry = info.bitsPerEntry;
+    header.index = static_cast<std::uint32_t>(info.index);
+    header.entries = info.entries;
+    header.payloadBytes = wordCount * 8;
+    header.payloadChecksum = checksum(words, wordCount);
+    header.headerChecksum = headerChecksum(header);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   std::fwrite(words, sizeof(std::uint64_t), wordCount, file) == wordCount;
+    written = (std::fclose(file) == 0) && written;
+    return written;
+}
+
+const char* Tablebase::describeError(TablebaseError error)
+{
+    switch (error) {
+        case TablebaseError::NONE:
+            return "no error";
+        case TablebaseError::OPEN_FAILED:
+            return "cannot open file";
+        case TablebaseError::BAD_MAGIC:
+            return "not a tablebase";
+        case TablebaseError::BAD_VERSION:
+            return "unsupported format version";
+        case TablebaseError::WRONG_BYTE_ORDER:
+            return "written with the other byte order";
+        case TablebaseError::BAD_HEADER:
+            return "corrupt header";
+        case TablebaseError::SIZE_MISMATCH:
+            return "file size does not match header";
+        case TablebaseError::BAD_CHECKSUM:
+            return "payload checksum mismatch";
+    }
+    return "unknown error";
+}
+
+bool Tablebase::fail(TablebaseError error)
+{
+    close();
+    error_ = error;
+    return false;
+}
+
+} // namespace tictactoe
@@ -0,0 +1,175 @@
+#include "game/transposition_table.h"
+
+namespace tictactoe {
+
+namespace {
+
+constexpr auto kRelaxed = std::memory_order_relaxed;
+
+} // namespace
+
+TranspositionTable::TranspositionTable(std::size_t capacity, Replacement replacement)
+    : bucketCount_(0)
+    , bucketMask_(0)
+    , replacement_(replacement)
+    , generation_(0)
+{
+    static_assert(sizeof(Bucket) == 64, "one bucket per cache line");
+    resize(capacity);
+}
+
+bool TranspositionTable::probe(std::uint64_t key, TTEntry& entry) const
+{
+    const Bucket& bucket = bucketFor(key);
+    for (const Slot& slot : bucket.slots) {
+        const std::uint64_t data = slot.data.load(kRelaxed);
+        if ((slot.check.load(kRelaxed) ^ data) != key) {
+            continue;
+        }
+        const TTEntry found = unpack(key, data);
+        if (found.bound != Bound::NONE) {
+            entry = found;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t key, int score, int move, int depth, Bound bound)
+{
+    Bucket& bucket = bucketFor(key);
+
+    // Same position first, then an empty slot, then the weakest entry:
+    // stale ones from earlier searches before shallow ones
+    Slot* victim = nullptr;
+    TTEntry victimEntry;
+    for (Slot& slot : bucket.slots) {
+        const std::uint64_t data = slot.data.load(kRelaxed);
+        const std::uint64_t slotKey = slot.check.load(kRelaxed) ^ data;
+        const TTEntry entry = unpack(slotKey, data);
+        if (entry.bound == Bound::NONE || slotKey == key) {
+            victim = &slot;
+            victimEntry = entry;
+            break;
+        }
+        if (victim == nullptr) {
+            victim = &slot;
+            victimEntry = entry;
+            continue;
+        }
+        const bool slotStale = entry.generation != generation_;
+        const bool victimStale = victimEntry.generation != generation_;
+        if (slotStale != victimStale ? slotStale : entry.depth < victimEntry.depth) {
+            victim = &slot;
+            victimEntry = entry;
+        }
+    }
+
+    // A newer result for the same position always wins
+    if (replacement_ == Replacement::DEPTH_PREFERRED &&
+        victimEntry.bound != Bound::NONE &&
+        victimEntry.key != key &&
+        victimEntry.generation == generation_ &&
+        victimEntry.depth > depth) {
+        return;
+    }
+
+    TTEntry entry;
+    entry.key = key;
+    entry.score = static_cast<std::int16_t>(score);
+    entry.move = static_cast<std::int16_t>(move);
+    entry.depth = static_cast<std::uint8_t>(depth);
+    entry.bound = bound;
+    entry.generation = generation_;
+
+    const std::uint64_t data = pack(entry);
+    victim->data.store(data, kRelaxed);
+    victim->check.store(key ^ data, kRelaxed);
+}
+
+void TranspositionTable::newSearch()
+{
+    ++generation_;
+}
+
+void TranspositionTable::clear()
+{
+    for (std::size_t i = 0; i < bucketCount_; ++i) {
+        for (Slot& slot : buckets_[i].slots) {
+            slot.data.store(0, kRelaxed);
+            slot.check.store(0, kRelaxed);
+        }
+    }
+    generation_ = 0;
+}
+
+void TranspositionTable::resize(std::size_t capacity)
+{
+    std::size_t bucketCount = 1;
+    while (bucketCount * kBucketSize < capacity) {
+        bucketCount <<= 1;
+    }
+    buckets_.reset(new Bucket[bucketCount]);
+    bucketCount_ = bucketCount;
+    bucketMask_ = bucketCount - 1;
+    generation_ = 0;
+}
+
+std::size_t TranspositionTable::getCapacity() const
+{
+    return bucketCount_ * kBucketSize;
+}
+
+TranspositionTable::Replacement TranspositionTable::getReplacement() const
+{
+    return replacement_;
+}
+
+void TranspositionTable::setReplacement(Replacement replacement)
+{
+    replacement_ = replacement;
+}
+
+std::size_t TranspositionTable::getUsage() const
+{
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < bucketCount_; ++i) {
+        for (const Slot& slot : buckets_[i].slots) {
+            used += (unpack(0, slot.data.load(kRelaxed)).bound != Bound::NONE) ? 1 : 0;
+        }
+    }
+    return used;
+}
+
+std::uint64_t TranspositionTable::pack(const TTEntry& entry)
+{
+    return static_cast<std::uint64_t>(static_cast<std::uint16_t>(entry.score)) |
+           static_cast<std::uint64_t>(static_cast<std::uint16_t>(entry.move)) << 16 |
+           static_cast<std::uint64_t>(entry.depth) << 32 |
+           static_cast<std::uint64_t>(entry.bound) << 40 |
+           static_cast<std::uint64_t>(entry.generation) << 48;
+}
+
+TTEntry TranspositionTable::unpack(std::uint64_t key, std::uint64_t data)
+{
+    TTEntry entry;
+    entry.key = key;
+    entry.score = static_cast<std::int16_t>(data & 0xFFFF);
+    entry.move = static_cast<std::int16_t>((data >> 16) & 0xFFFF);
+    entry.depth = static_cast<std::uint8_t>((data >> 32) & 0xFF);
+    entry.bound = static_cast<Bound>((data >> 40) & 0xFF);
+    entry.generation = static_cast<std::uint8_t>((data >> 48) & 0xFF);
+    return entry;
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(std::uint64_t key)
+{
+    return buckets_[key & bucketMask_];
+}
+
+const TranspositionTable::Bucket& TranspositionTable::bucketFor(std::uint64_t key) const
+{
+    return buckets_[key & bucketMask_];
+}
+
+} // namespace tictactoe
@@ -0,0 +1,372 @@
+#include "game/ultimate_ai_opponent.h"
+#include <algorithm>
+#include <utility>
+
+namespace tictactoe {
+
+namespace {
+
+// Same scale as BasicAIOpponent: anything past kDecisiveScore is proven
+constexpr int kWinScore = 30000;
+constexpr int kInfinity = kWinScore + 1;
+constexpr int kDecisiveScore = kWinScore - 1000;
+constexpr int kMaxHeuristic = 10000;
+
+using SubMask = UltimateGameEngine::SubMask;
+
+// The 3x3 lines, used both within a sub-board and on the meta board
+constexpr auto& kLines = ClassicGameEngine::Lines::kMasks;
+
+// Sub-boards and squares by the lines through them: centre, corners, edges
+constexpr int kSquareWeights[9] = {3, 2, 3, 2, 4, 2, 3, 2, 3};
+
+// Value of an open line holding one or two stones, on a sub-board and on
+// the meta board; a won sub-board is worth more than any line inside one
+constexpr int kBoardLineWeights[3] = {0, 1, 6};
+constexpr int kMetaLineWeights[3] = {0, 30, 150};
+constexpr int kWonBoardWeight = 40;
+// The side to move picking its own sub-board
+constexpr int kFreeChoiceBonus = 10;
+
+int toTableScore(int score, int ply)
+{
+    if (score > kDecisiveScore) {
+        return score + ply;
+    }
+    return (score < -kDecisiveScore) ? score - ply : score;
+}
+
+int fromTableScore(int score, int ply)
+{
+    if (score > kDecisiveScore) {
+        return score - ply;
+    }
+    return (score < -kDecisiveScore) ? score + ply : score;
+}
+
+// True if one more stone on an empty square completes a line
+bool canCompleteLine(SubMask own, SubMask empty)
+{
+    for (; empty != 0; empty = static_cast<SubMask>(empty & (empty - 1))) {
+        if (UltimateGameEngine::hasLine(static_cast<SubMask>(own | (empty & -empty)))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+UltimateAIOpponent::UltimateAIOpponent(std::size_t tableCapacity)
+    : table_(tableCapacity)
+    , nextClockCheck_(0)
+    , stopped_(false)
+{
+}
+
+int UltimateAIOpponent::calculateBestMove(const UltimateGameEngine& engine)
+{
+    stats_ = SearchStats{};
+    if (engine.isGameOver()) {
+        return -1;
+    }
+
+    const Clock::time_point start = Clock::now();
+    engine_ = engine;
+    table_.newSearch();
+    stopped_ = false;
+    nextClockCheck_ = 0;
+    const bool bounded = limits_.moveTime.count() != 0 || limits_.maxNodes != 0;
+    deadline_ = start + (bounded ? limits_.moveTime : kDefaultMoveTime);
+
+    Moves moves;
+    const int count = orderMoves(-1, moves);
+    const int emptyCells = UltimateGameEngine::kCells - engine_.getMoveCount();
+    const int maxDepth = (limits_.maxDepth > 0) ? std::min(limits_.maxDepth, emptyCells) : emptyCells;
+
+    // Iterative deepening with the previous best move searched first, so an
+    // unfinished pass can only replace it with a proven improvement
+    int bestMove = moves[0];
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        int alpha = -kInfinity;
+        int move = -1;
+        for (int i = 0; i < count; ++i) {
+            engine_.makeMove(moves[i]);
+            ++stats_.nodes;
+            int score = 0;
+            switch (engine_.getGameState()) {
+                case GameState::IN_PROGRESS:
+                    score = -negamax(1, depth - 1, -kInfinity, -alpha);
+                    break;
+                case GameState::DRAW:
+                    break;
+                default:
+                    score = kWinScore;
+                    break;
+            }
+            engine_.undoMove();
+            if (stopped_) {
+                break;
+            }
+            if (score > alpha) {
+                alpha = score;
+                move = moves[i];
+            }
+        }
+        if (move >= 0) {
+            bestMove = move;
+            const auto found = std::find(moves.begin(), moves.begin() + count, move);
+            std::rotate(moves.begin(), found, found + 1);
+        }
+        if (stopped_) {
+            break;
+        }
+        stats_.completedDepth = depth;
+        // A proven result will not change with more depth
+        if (alpha > kDecisiveScore || alpha < -kDecisiveScore) {
+            break;
+        }
+    }
+
+    stats_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+    if (statsCallback_) {
+        statsCallback_(stats_);
+    }
+    return bestMove;
+}
+
+int UltimateAIOpponent::negamax(int ply, int depth, int alpha, int beta)
+{
+    if (outOfBudget()) {
+        return 0;
+    }
+    stats_.maxPly = std::max(stats_.maxPly, ply);
+    if (depth <= 0) {
+        return evaluatePosition(engine_);
+    }
+
+    const std::uint64_t key = engine_.getZobristKey();
+    int tableMove = -1;
+    TTEntry entry;
+    if (table_.probe(key, entry)) {
+        ++stats_.tableHits;
+        const int score = fromTableScore(entry.score, ply);
+        if (entry.depth >= depth &&
+            (entry.bound == Bound::EXACT ||
+             (entry.bound == Bound::LOWER && score >= beta) ||
+             (entry.bound == Bound::UPPER && score <= alpha))) {
+            ++stats_.tableCutoffs;
+            return score;
+        }
+        tableMove = entry.move;
+    } else {
+        ++stats_.tableMisses;
+    }
+
+    Moves moves;
+    const int count = orderMoves(tableMove, moves);
+    const int alphaOrig = alpha;
+    int bestScore = -kInfinity;
+    int bestMove = -1;
+    ++stats_.expandedNodes;
+
+    for (int i = 0; i < count; ++i) {
+        engine_.makeMove(moves[i]);
+        ++stats_.nodes;
+        int score = 0;
+        switch (engine_.getGameState()) {
+            case GameState::IN_PROGRESS:
+                score = -negamax(ply + 1, depth - 1, -beta, -alpha);
+                break;
+            case GameState::DRAW:
+                break;
+            default:
+                score = kWinScore - ply;
+                break;
+        }
+        engine_.undoMove();
+
+        if (stopped_) {
+            return 0;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = moves[i];
+        }
+        alpha = std::max(alpha, bestScore);
+        if (alpha >= beta) {
+            ++stats_.cutoffs;
+            stats_.firstMoveCutoffs += (i == 0) ? 1 : 0;
+            break;
+        }
+    }
+
+    Bound bound = Bound::EXACT;
+    if (bestScore <= alphaOrig) {
+        bound = Bound::UPPER;
+    } else if (bestScore >= beta) {
+        bound = Bound::LOWER;
+    }
+    table_.store(key, toTableScore(bestScore, ply), bestMove, depth, bound);
+
+    return bestScore;
+}
+
+int UltimateAIOpponent::orderMoves(int tableMove, Moves& moves) const
+{
+    const Player mover = engine_.getCurrentPlayer();
+    const Player other = (mover == Player::X) ? Player::O : Player::X;
+    const SubMask closed = engine_.getClosedBoards();
+
+    // Priority per move: the stored best move, then sub-board wins and
+    // blocks; sending the opponent to a free choice or to a sub-board it
+    // can win at once goes last
+    std::array<int, UltimateGameEngine::kCells> priorities;
+    int count = 0;
+    for (SubMask boards = engine_.getPlayableBoards(); boards != 0; boards = static_cast<SubMask>(boards & (boards - 1))) {
+        const int board = lowestBit64(boards);
+        const SubMask own = engine_.getSquares(board, mover);
+        const SubMask theirs = engine_.getSquares(board, other);
+        for (SubMask empty = engine_.getEmptySquares(board); empty != 0; empty = static_cast<SubMask>(empty & (empty - 1))) {
+            const int square = lowestBit64(empty);
+            const SubMask bit = static_cast<SubMask>(1u << square);
+            const int cell = UltimateGameEngine::cellOf(board, square);
+
+            int priority = kSquareWeights[square];
+            const bool wins = UltimateGameEngine::hasLine(static_cast<SubMask>(own | bit));
+            if (cell == tableMove) {
+                priority += 1000;
+            }
+            if (wins) {
+                priority += 100;
+            } else if (UltimateGameEngine::hasLine(static_cast<SubMask>(theirs | bit))) {
+                priority += 50;
+            }
+
+            // Where the opponent goes next; a sub-board this move closes
+            // gives it a free choice as well
+            const bool closesBoard = wins || engine_.getEmptySquares(board) == bit;
+            if (((closed >> square) & 1u) || (square == board && closesBoard)) {
+                priority -= 100;
+            } else {
+                const SubMask targetEmpty = static_cast<SubMask>(engine_.getEmptySquares(square) & ~(square == board ? bit : 0));
+                const SubMask targetTheirs = engine_.getSquares(square, other);
+                if (canCompleteLine(targetTheirs, targetEmpty)) {
+                    priority -= 60;
+                }
+            }
+
+            // Insertion sort; ties keep board and square order
+            int i = count++;
+            for (; i > 0 && priorities[i - 1] < priority; --i) {
+                moves[i] = moves[i - 1];
+                priorities[i] = priorities[i - 1];
+            }
+            moves[i] = cell;
+            priorities[i] = priority;
+        }
+    }
+    return count;
+}
+
+int UltimateAIOpponent::evaluatePosition(const UltimateGameEngine& engine)
+{
+    const Player mover = engine.getCurrentPlayer();
+    const Player other = (mover == Player::X) ? Player::O : Player::X;
+    const SubMask closed = engine.getClosedBoards();
+    const SubMask wonOwn = engine.getWonBoards(mover);
+    const SubMask wonTheirs = engine.getWonBoards(other);
+    const SubMask drawn = static_cast<SubMask>(closed & ~(wonOwn | wonTheirs));
+
+    int score = (engine.getForcedBoard() == UltimateGameEngine::kAnyBoard) ? kFreeChoiceBonus : 0;
+
+    // Lines open to one side only on the sub-boards still in play,
+    // weighted by where the sub-board sits on the meta board
+    for (int board = 0; board < UltimateGameEngine::kBoards; ++board) {
+        if ((closed >> board) & 1u) {
+            continue;
+        }
+        const SubMask own = engine.getSquares(board, mover);
+        const SubMask theirs = engine.getSquares(board, other);
+        int boardScore = 0;
+        for (const auto line : kLines) {
+            const int ownCount = popCount64(own & line);
+            const int theirCount = popCount64(theirs & line);
+            if (theirCount == 0) {
+                boardScore += kBoardLineWeights[ownCount];
+            } else if (ownCount == 0) {
+                boardScore -= kBoardLineWeights[theirCount];
+            }
+        }
+        score += boardScore * kSquareWeights[board];
+    }
+
+    // Won sub-boards, and meta lines neither blocked by the opponent nor
+    // by a drawn sub-board. Neither side has a full meta line here.
+    for (int board = 0; board < UltimateGameEngine::kBoards; ++board) {
+        if ((wonOwn >> board) & 1u) {
+            score += kWonBoardWeight * kSquareWeights[board];
+        } else if ((wonTheirs >> board) & 1u) {
+            score -= kWonBoardWeight * kSquareWeights[board];
+        }
+    }
+    for (const auto line : kLines) {
+        if ((line & drawn) != 0) {
+            continue;
+        }
+        const int ownCount = popCount64(wonOwn & line);
+        const int theirCount = popCount64(wonTheirs & line);
+        if (theirCount == 0) {
+            score += kMetaLineWeights[ownCount];
+        } else if (ownCount == 0) {
+            score -= kMetaLineWeights[theirCount];
+        }
+    }
+    return std::clamp(score, -kMaxHeuristic, kMaxHeuristic);
+}
+
+bool UltimateAIOpponent::outOfBudget()
+{
+    if (stopped_) {
+        return true;
+    }
+
+    // Reading the clock costs more than a node, so it is only read every
+    // 256 nodes
+    bool exhausted = (limits_.maxNodes != 0 && stats_.nodes >= limits_.maxNodes) ||
+                     (limits_.cancel != nullptr && limits_.cancel->load(std::memory_order_relaxed));
+    const bool timed = limits_.moveTime.count() != 0 || limits_.maxNodes == 0;
+    if (!exhausted && timed && stats_.nodes >= nextClockCheck_) {
+        nextClockCheck_ = stats_.nodes + 256;
+        exhausted = Clock::now() >= deadline_;
+    }
+    stopped_ = exhausted;
+    return exhausted;
+}
+
+TranspositionTable& UltimateAIOpponent::getTranspositionTable()
+{
+    return table_;
+}
+
+void UltimateAIOpponent::setSearchLimits(const SearchLimits& limits)
+{
+    limits_ = limits;
+}
+
+const SearchLimits& UltimateAIOpponent::getSearchLimits() const
+{
+    return limits_;
+}
+
+const SearchStats& UltimateAIOpponent::getSearchStats() const
+{
+    return stats_;
+}
+
+void UltimateAIOpponent::setStatsCallback(StatsCallback callback)
+{
+    statsCallback_ = std::move(callback);
+}
+
+} // namespace tictactoe
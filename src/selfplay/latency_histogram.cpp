@@ -0,0 +1,93 @@
+#include "selfplay/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace tictactoe {
+
+LatencyHistogram::LatencyHistogram()
+    : count_(0)
+    , total_(0)
+    , max_(0)
+{
+    buckets_.fill(0);
+}
+
+void LatencyHistogram::record(std::uint64_t nanoseconds)
+{
+    ++buckets_[bucketFor(nanoseconds)];
+    ++count_;
+    total_ += nanoseconds;
+    max_ = std::max(max_, nanoseconds);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (int i = 0; i < kBucketCount; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    total_ += other.total_;
+    max_ = std::max(max_, other.max_);
+}
+
+std::uint64_t LatencyHistogram::getCount() const
+{
+    return count_;
+}
+
+std::uint64_t LatencyHistogram::getMax() const
+{
+    return max_;
+}
+
+double LatencyHistogram::getMean() const
+{
+    return count_ == 0 ? 0.0 : static_cast<double>(total_) / static_cast<double>(count_);
+}
+
+std::uint64_t LatencyHistogram::percentile(double percent) const
+{
+    if (count_ == 0) {
+        return 0;
+    }
+
+    const auto rank = static_cast<std::uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(count_)));
+    std::uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i];
+        if (seen >= std::max<std::uint64_t>(rank, 1)) {
+            return std::min(bucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+int LatencyHistogram::bucketFor(std::uint64_t nanoseconds)
+{
+    // Values below kSubBuckets get exact buckets
+    if (nanoseconds < kSubBuckets) {
+        return static_cast<int>(nanoseconds);
+    }
+
+    int exponent = 0;
+    while ((nanoseconds >> (exponent + 1)) != 0) {
+        ++exponent;
+    }
+    const int sub = static_cast<int>((nanoseconds >> (exponent - 3)) & (kSubBuckets - 1));
+    return (exponent - 2) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(int bucket)
+{
+    if (bucket < kSubBuckets) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+
+    const int exponent = bucket / kSubBuckets + 2;
+    const int sub = bucket % kSubBuckets;
+    const std::uint64_t base = std::uint64_t{1} << exponent;
+    const std::uint64_t step = base / kSubBuckets;
+    return base + step * static_cast<std::uint64_t>(sub + 1) - 1;
+}
+
+} // namespace tictactoe
@@ -0,0 +1,151 @@
+#include "selfplay/policies.h"
+#include "game/ai_opponent.h"
+#include "game/mcts_opponent.h"
+#include <cstdlib>
+
+namespace tictactoe {
+
+namespace {
+
+class RandomPolicy : public MovePolicy {
+public:
+    int chooseMove(const ClassicGameEngine& engine, std::mt19937_64& rng) override
+    {
+        return randomCell(engine.getLegalMoves(), rng);
+    }
+};
+
+class PerfectPolicy : public MovePolicy {
+public:
+    int chooseMove(const ClassicGameEngine& engine, std::mt19937_64& rng) override
+    {
+        (void)rng;
+        auto move = ai_.calculateBestMove(engine.getBoard(), engine.getCurrentPlayer());
+        return move.first * ClassicGameEngine::kSize + move.second;
+    }
+
+private:
+    AIOpponent ai_;
+};
+
+// Random move with probability epsilon, perfect play otherwise
+class EpsilonGreedyPolicy : public MovePolicy {
+public:
+    explicit EpsilonGreedyPolicy(double epsilon)
+        : epsilon_(epsilon)
+    {
+    }
+
+    int chooseMove(const ClassicGameEngine& engine, std::mt19937_64& rng) override
+    {
+        if (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < epsilon_) {
+            return randomCell(engine.getLegalMoves(), rng);
+        }
+        return perfect_.chooseMove(engine, rng);
+    }
+
+private:
+    double epsilon_;
+    PerfectPolicy perfect_;
+};
+
+// Monte Carlo tree search with a fixed number of playouts per move, seeded
+// from the game's generator so runs stay reproducible
+class MCTSPolicy : public MovePolicy {
+public:
+    explicit MCTSPolicy(std::uint64_t playouts)
+    {
+        SearchLimits limits;
+        limits.maxNodes = playouts;
+        mcts_.setSearchLimits(limits);
+    }
+
+    int chooseMove(const ClassicGameEngine& engine, std::mt19937_64& rng) override
+    {
+        mcts_.setSeed(rng());
+        return mcts_.calculateBestMove(engine);
+    }
+
+private:
+    MCTSOpponent mcts_;
+};
+
+} // namespace
+
+bool parsePolicySpec(const std::string& text, PolicySpec& spec)
+{
+    if (text == "random") {
+        spec.type = PolicyType::RANDOM;
+        return true;
+    }
+    if (text == "perfect") {
+        spec.type = PolicyType::PERFECT;
+        return true;
+    }
+    if (text.rfind("epsilon", 0) == 0) {
+        spec.type = PolicyType::EPSILON_GREEDY;
+        if (text.size() == 7) {
+            return true;
+        }
+        if (text[7] != ':') {
+            return false;
+        }
+        char* end = nullptr;
+        spec.epsilon = std::strtod(text.c_str() + 8, &end);
+        return end != text.c_str() + 8 && *end == '\0' && spec.epsilon >= 0.0 && spec.epsilon <= 1.0;
+    }
+    if (text.rfind("mcts", 0) == 0) {
+        spec.type = PolicyType::MCTS;
+        if (text.size() == 4) {
+            return true;
+        }
+        if (text[4] != ':') {
+            return false;
+        }
+        char* end = nullptr;
+        spec.playouts = std::strtoull(text.c_str() + 5, &end, 10);
+        return end != text.c_str() + 5 && *end == '\0' && spec.playouts > 0;
+    }
+    return false;
+}
+
+std::string describePolicy(const PolicySpec& spec)
+{
+    switch (spec.type) {
+        case PolicyType::RANDOM:
+            return "random";
+        case PolicyType::PERFECT:
+            return "perfect";
+        case PolicyType::EPSILON_GREEDY:
+            return "epsilon:" + std::to_string(spec.epsilon);
+        case PolicyType::MCTS:
+            return "mcts:" + std::to_string(spec.playouts);
+    }
+    return "unknown";
+}
+
+std::unique_ptr<MovePolicy> makePolicy(const PolicySpec& spec)
+{
+    switch (spec.type) {
+        case PolicyType::PERFECT:
+            return std::make_unique<PerfectPolicy>();
+        case PolicyType::EPSILON_GREEDY:
+            return std::make_unique<EpsilonGreedyPolicy>(spec.epsilon);
+        case PolicyType::MCTS:
+            return std::make_unique<MCTSPolicy>(spec.playouts);
+        case PolicyType::RANDOM:
+        default:
+            return std::make_unique<RandomPolicy>();
+    }
+}
+
+int randomCell(ClassicGameEngine::Mask mask, std::mt19937_64& rng)
+{
+    int skip = std::uniform_int_distribution<int>(0, cellCount(mask) - 1)(rng);
+    while (skip-- > 0) {
+        popLowestCell(mask);
+    }
+    return lowestCell(mask);
+}
+
+} // namespace tictactoe
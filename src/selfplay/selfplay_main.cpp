@@ -0,0 +1,107 @@
+#include "selfplay/simulator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+void printUsage(const char* program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [options]\n"
+                 "  --games N        games to play (default 100000)\n"
+                 "  --x POLICY       policy for X (default random)\n"
+                 "  --o POLICY       policy for O (default random)\n"
+                 "  --threads N      worker threads, 0 = all cores (default 0)\n"
+                 "  --seed N         base random seed (default 1)\n"
+                 "  --chunk N        games per scheduled task (default 256)\n"
+                 "POLICY is random, perfect, epsilon[:E] or mcts[:P]\n",
+                 program);
+}
+
+bool parseUnsigned(const char* text, std::uint64_t& value)
+{
+    char* end = nullptr;
+    value = std::strtoull(text, &end, 10);
+    return end != text && *end == '\0';
+}
+
+void printLatency(const char* label, const tictactoe::LatencyHistogram& histogram)
+{
+    std::printf("%-4s moves %10llu  mean %9.0f ns  p50 %9llu  p90 %9llu  p99 %9llu  p99.9 %9llu  max %9llu\n",
+                label,
+                static_cast<unsigned long long>(histogram.getCount()),
+                histogram.getMean(),
+                static_cast<unsigned long long>(histogram.percentile(50.0)),
+                static_cast<unsigned long long>(histogram.percentile(90.0)),
+                static_cast<unsigned long long>(histogram.percentile(99.0)),
+                static_cast<unsigned long long>(histogram.percentile(99.9)),
+                static_cast<unsigned long long>(histogram.getMax()));
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace tictactoe;
+
+    SelfPlayConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+        if (std::strcmp(option, "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const char* value = argv[++i];
+        std::uint64_t number = 0;
+        bool ok = true;
+        if (std::strcmp(option, "--games") == 0) {
+            ok = parseUnsigned(value, config.games);
+        } else if (std::strcmp(option, "--x") == 0) {
+            ok = parsePolicySpec(value, config.xPolicy);
+        } else if (std::strcmp(option, "--o") == 0) {
+            ok = parsePolicySpec(value, config.oPolicy);
+        } else if (std::strcmp(option, "--threads") == 0) {
+            ok = parseUnsigned(value, number);
+            config.threads = static_cast<unsigned>(number);
+        } else if (std::strcmp(option, "--seed") == 0) {
+            ok = parseUnsigned(value, config.seed);
+        } else if (std::strcmp(option, "--chunk") == 0) {
+            ok = parseUnsigned(value, config.gamesPerTask);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::fprintf(stderr, "Invalid argument: %s %s\n", option, value);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    const SelfPlayReport report = runSelfPlay(config);
+
+    const double games = report.games > 0 ? static_cast<double>(report.games) : 1.0;
+    std::printf("X: %s  O: %s  threads: %u\n",
+                describePolicy(config.xPolicy).c_str(),
+                describePolicy(config.oPolicy).c_str(),
+                report.threads);
+    std::printf("games %llu in %.3f s  (%.0f games/s, %.0f moves/s)\n",
+                static_cast<unsigned long long>(report.games),
+                report.seconds,
+                report.gamesPerSecond(),
+                report.seconds > 0.0 ? static_cast<double>(report.moves) / report.seconds : 0.0);
+    std::printf("X won %.2f%%  O won %.2f%%  draw %.2f%%\n",
+                100.0 * static_cast<double>(report.xWins) / games,
+                100.0 * static_cast<double>(report.oWins) / games,
+                100.0 * static_cast<double>(report.draws) / games);
+    printLatency("X", report.xLatency);
+    printLatency("O", report.oLatency);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "selfplay/simulator.h"
+#include "concurrency/work_stealing_pool.h"
+#include "game/zobrist.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace tictactoe {
+
+namespace {
+
+void playGames(const SelfPlayConfig& config, std::uint64_t taskIndex, std::uint64_t games, SelfPlayReport& result)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::mt19937_64 rng(detail::splitMix64(config.seed ^ detail::splitMix64(taskIndex)));
+    auto xPolicy = makePolicy(config.xPolicy);
+    auto oPolicy = makePolicy(config.oPolicy);
+
+    ClassicGameEngine engine;
+    for (std::uint64_t game = 0; game < games; ++game) {
+        engine.resetGame();
+        while (!engine.isGameOver()) {
+            const bool xToMove = engine.getCurrentPlayer() == Player::X;
+            MovePolicy& policy = xToMove ? *xPolicy : *oPolicy;
+
+            const auto start = Clock::now();
+            const int cell = policy.chooseMove(engine, rng);
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+            (xToMove ? result.xLatency : result.oLatency).record(static_cast<std::uint64_t>(elapsed.count()));
+
+            engine.makeMove(cell);
+            ++result.moves;
+        }
+
+        switch (engine.getGameState()) {
+            case GameState::X_WON:
+                ++result.xWins;
+                break;
+            case GameState::O_WON:
+                ++result.oWins;
+                break;
+            default:
+                ++result.draws;
+                break;
+        }
+        ++result.games;
+    }
+}
+
+} // namespace
+
+double SelfPlayReport::gamesPerSecond() const
+{
+    return seconds > 0.0 ? static_cast<double>(games) / seconds : 0.0;
+}
+
+SelfPlayReport runSelfPlay(const SelfPlayConfig& config)
+{
+    const std::uint64_t perTask = std::max<std::uint64_t>(config.gamesPerTask, 1);
+    const std::uint64_t taskCount = (config.games + perTask - 1) / perTask;
+
+    const auto start = std::chrono::steady_clock::now();
+    WorkStealingPool pool(config.threads);
+    // One report per worker, so memory does not grow with the game count;
+    // each task adds to the report of the worker running it
+    std::vector<SelfPlayReport> partials(pool.getThreadCount());
+    for (std::uint64_t task = 0; task < taskCount; ++task) {
+        const std::uint64_t games = std::min(perTask, config.games - task * perTask);
+        pool.submit([&config, &partials, task, games] {
+            playGames(config, task, games, partials[WorkStealingPool::currentWorkerIndex()]);
+        });
+    }
+    pool.wait();
+
+    SelfPlayReport report;
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.threads = pool.getThreadCount();
+    for (const auto& partial : partials) {
+        report.games += partial.games;
+        report.xWins += partial.xWins;
+        report.oWins += partial.oWins;
+        report.draws += partial.draws;
+        report.moves += partial.moves;
+        report.xLatency.merge(partial.xLatency);
+        report.oLatency.merge(partial.oLatency);
+    }
+    return report;
+}
+
+} // namespace tictactoe
@@ -0,0 +1,160 @@
+#include "game/proof_solver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace tictactoe;
+
+void printUsage(const char* program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [options]\n"
+                 "  --board SIZE     3, 4, 5 (four in a row) or 6 (four in a row) (default 5)\n"
+                 "  --moves LIST     opening cells played first, comma separated (default none)\n"
+                 "  --table-mb N     hash table size in MB (default 64)\n"
+                 "  --time SECONDS   give up after this long, 0 = no limit (default 0)\n"
+                 "  --nodes N        give up after this many positions, 0 = no limit (default 0)\n"
+                 "  --interval N     positions between progress reports (default 1048576)\n",
+                 program);
+}
+
+bool parseUnsigned(const char* text, unsigned long long& value)
+{
+    char* end = nullptr;
+    value = std::strtoull(text, &end, 10);
+    return end != text && *end == '\0';
+}
+
+bool parseMoves(const char* text, std::vector<int>& moves)
+{
+    while (*text != '\0') {
+        char* end = nullptr;
+        const long cell = std::strtol(text, &end, 10);
+        if (end == text || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        moves.push_back(static_cast<int>(cell));
+        text = (*end == ',') ? end + 1 : end;
+    }
+    return true;
+}
+
+const char* describeOutcome(Outcome outcome)
+{
+    switch (outcome) {
+        case Outcome::WIN:
+            return "win";
+        case Outcome::LOSS:
+            return "loss";
+        case Outcome::DRAW:
+            return "draw";
+        case Outcome::UNKNOWN:
+            break;
+    }
+    return "unknown";
+}
+
+void printProgress(const ProofProgress& progress)
+{
+    std::printf("  %c wins?  %12llu nodes  pn %10u  dn %10u  table %5.1f%%  %8.1f s\n",
+                progress.attacker == Player::X ? 'X' : 'O',
+                static_cast<unsigned long long>(progress.nodes), progress.proofNumber,
+                progress.disproofNumber,
+                100.0 * static_cast<double>(progress.tableEntries) / static_cast<double>(progress.tableCapacity),
+                static_cast<double>(progress.elapsed.count()) / 1e6);
+    std::fflush(stdout);
+}
+
+template <typename Engine>
+int prove(const std::vector<int>& moves, const SearchLimits& limits, std::size_t tableBytes,
+          std::uint64_t interval)
+{
+    Engine engine;
+    for (const int cell : moves) {
+        if (!engine.makeMove(cell)) {
+            std::fprintf(stderr, "Illegal opening move %d\n", cell);
+            return 1;
+        }
+    }
+
+    BasicProofSolver<Engine> solver(tableBytes);
+    solver.setSearchLimits(limits);
+    solver.setProgressCallback(printProgress, interval);
+
+    const auto start = std::chrono::steady_clock::now();
+    const Outcome outcome = solver.solve(engine);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%dx%d, %d in a row, %zu opening moves: %s for %c (%.2f s, %zu table entries)\n",
+                Engine::kSize, Engine::kSize, Engine::kWinLength, moves.size(), describeOutcome(outcome),
+                engine.getCurrentPlayer() == Player::X ? 'X' : 'O', seconds, solver.getTableCapacity());
+    if (solver.getProvenMove() >= 0) {
+        std::printf("  proven move: %d\n", solver.getProvenMove());
+    }
+    return outcome == Outcome::UNKNOWN ? 2 : 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    unsigned long long board = 5;
+    unsigned long long tableMegabytes = 64;
+    unsigned long long seconds = 0;
+    unsigned long long nodes = 0;
+    unsigned long long interval = BasicProofSolver<GameEngine5x5>::kDefaultProgressInterval;
+    std::vector<int> moves;
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+        if (std::strcmp(option, "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (std::strcmp(option, "--board") == 0) {
+            ok = parseUnsigned(value, board) && board >= 3 && board <= 6;
+        } else if (std::strcmp(option, "--moves") == 0) {
+            ok = parseMoves(value, moves);
+        } else if (std::strcmp(option, "--table-mb") == 0) {
+            ok = parseUnsigned(value, tableMegabytes) && tableMegabytes > 0;
+        } else if (std::strcmp(option, "--time") == 0) {
+            ok = parseUnsigned(value, seconds);
+        } else if (std::strcmp(option, "--nodes") == 0) {
+            ok = parseUnsigned(value, nodes);
+        } else if (std::strcmp(option, "--interval") == 0) {
+            ok = parseUnsigned(value, interval) && interval > 0;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    SearchLimits limits;
+    limits.moveTime = std::chrono::seconds(seconds);
+    limits.maxNodes = nodes;
+    const std::size_t tableBytes = static_cast<std::size_t>(tableMegabytes) << 20;
+
+    switch (board) {
+        case 3:
+            return prove<ClassicGameEngine>(moves, limits, tableBytes, interval);
+        case 4:
+            return prove<GameEngine4x4>(moves, limits, tableBytes, interval);
+        case 5:
+            return prove<GameEngine5x5>(moves, limits, tableBytes, interval);
+        default:
+            return prove<GameEngine6x6>(moves, limits, tableBytes, interval);
+    }
+}
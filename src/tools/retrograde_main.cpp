@@ -0,0 +1,131 @@
+#include "game/retrograde_solver.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+
+using namespace tictactoe;
+
+void printUsage(const char* program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [options]\n"
+                 "  --board SIZE     3 or 4 (default 4)\n"
+                 "  --threads N      worker threads, 0 = all cores (default 0)\n"
+                 "  --output PATH    tablebase file to write (default tictactoe_SIZExSIZE.tablebase)\n"
+                 "  --verify PATH    check an existing tablebase file instead of solving\n",
+                 program);
+}
+
+bool parseUnsigned(const char* text, unsigned& value)
+{
+    char* end = nullptr;
+    value = static_cast<unsigned>(std::strtoul(text, &end, 10));
+    return end != text && *end == '\0';
+}
+
+const char* describeOutcome(Outcome outcome)
+{
+    switch (outcome) {
+        case Outcome::WIN:
+            return "win";
+        case Outcome::LOSS:
+            return "loss";
+        case Outcome::DRAW:
+            return "draw";
+        case Outcome::UNKNOWN:
+            break;
+    }
+    return "unknown";
+}
+
+template <typename Engine>
+int solveAndWrite(unsigned threads, const std::string& path)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const OutcomeTable<Engine> table = RetrogradeSolver<Engine>::solve(threads);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto counts = table.countOutcomes();
+    std::printf("%dx%d: %llu positions solved in %.2f s\n", Engine::kSize, Engine::kSize,
+                static_cast<unsigned long long>(OutcomeTable<Engine>::kPositions), seconds);
+    std::printf("  wins %llu  losses %llu  draws %llu  unreachable %llu\n",
+                static_cast<unsigned long long>(counts[static_cast<int>(Outcome::WIN)]),
+                static_cast<unsigned long long>(counts[static_cast<int>(Outcome::LOSS)]),
+                static_cast<unsigned long long>(counts[static_cast<int>(Outcome::DRAW)]),
+                static_cast<unsigned long long>(counts[static_cast<int>(Outcome::UNKNOWN)]));
+    std::printf("  empty board: %s for X\n", describeOutcome(table.lookup(Engine())));
+
+    if (!table.save(path)) {
+        std::fprintf(stderr, "Could not write %s\n", path.c_str());
+        return 1;
+    }
+    std::printf("  written to %s\n", path.c_str());
+    return 0;
+}
+
+// Open with the full checksum and describe the file
+int verifyFile(const std::string& path)
+{
+    Tablebase base;
+    if (!base.open(path, Tablebase::Verify::FULL)) {
+        std::fprintf(stderr, "%s: %s\n", path.c_str(), Tablebase::describeError(base.getError()));
+        return 1;
+    }
+    const TablebaseInfo& info = base.getInfo();
+    std::printf("%s: %u cells, %u in a row, %u dimensions, %llu entries of %u bits, %s\n",
+                path.c_str(), info.cells, info.winLength, info.dimensions,
+                static_cast<unsigned long long>(info.entries), info.bitsPerEntry,
+                base.isMapped() ? "mapped" : "read into memory");
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    unsigned board = 4;
+    unsigned threads = 0;
+    std::string output;
+    std::string verify;
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+        if (std::strcmp(option, "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (std::strcmp(option, "--board") == 0) {
+            ok = parseUnsigned(value, board) && (board == 3 || board == 4);
+        } else if (std::strcmp(option, "--threads") == 0) {
+            ok = parseUnsigned(value, threads);
+        } else if (std::strcmp(option, "--output") == 0) {
+            output = value;
+        } else if (std::strcmp(option, "--verify") == 0) {
+            verify = value;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!verify.empty()) {
+        return verifyFile(verify);
+    }
+    if (output.empty()) {
+        output = "tictactoe_" + std::to_string(board) + "x" + std::to_string(board) + ".tablebase";
+    }
+
+    return (board == 3) ? solveAndWrite<ClassicGameEngine>(threads, output)
+                        : solveAndWrite<GameEngine4x4>(threads, output);
+}
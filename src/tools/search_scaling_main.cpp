@@ -0,0 +1,157 @@
+#include "game/ai_opponent.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace tictactoe;
+
+struct Sample {
+    double milliseconds = 0.0;
+    SearchStats stats;
+    int move = -1;
+};
+
+void printUsage(const char* program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [options]\n"
+                 "  --threads N      largest thread count to try, 0 = all cores (default 0)\n"
+                 "  --repeat N       runs per point, the fastest is kept (default 3)\n"
+                 "  --mode MODE      root, lazy or both (default both)\n",
+                 program);
+}
+
+bool parseUnsigned(const char* text, unsigned& value)
+{
+    char* end = nullptr;
+    value = static_cast<unsigned>(std::strtoul(text, &end, 10));
+    return end != text && *end == '\0';
+}
+
+const char* describeMode(ParallelMode mode)
+{
+    return mode == ParallelMode::ROOT_SPLIT ? "root" : "lazy";
+}
+
+// Solve one position from a cold table
+template <typename Engine>
+Sample measure(const std::vector<int>& moves, unsigned threads, ParallelMode mode, unsigned repeat)
+{
+    Engine engine;
+    for (const int cell : moves) {
+        engine.makeMove(cell);
+    }
+
+    Sample best;
+    for (unsigned run = 0; run < repeat; ++run) {
+        BasicAIOpponent<Engine> ai(std::size_t(1) << 20);
+        ai.setThreadCount(threads);
+        ai.setParallelMode(mode);
+
+        const auto start = std::chrono::steady_clock::now();
+        const int move = ai.calculateBestMove(engine);
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (run == 0 || ms < best.milliseconds) {
+            best = Sample{ms, ai.getSearchStats(), move};
+        }
+    }
+    return best;
+}
+
+template <typename Engine>
+void report(const char* name, const std::vector<int>& moves, unsigned maxThreads,
+            const std::vector<ParallelMode>& modes, unsigned repeat)
+{
+    std::printf("\n%s\n", name);
+    std::printf("%-6s %7s %10s %12s %10s %8s %6s %6s %6s\n",
+                "mode", "threads", "ms", "nodes", "Mnodes/s", "speedup", "bf", "tt%", "move");
+    // 1, 2, 4, ... and maxThreads itself
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+
+    for (const ParallelMode mode : modes) {
+        double baseline = 0.0;
+        for (const unsigned threads : counts) {
+            const Sample sample = measure<Engine>(moves, threads, mode, repeat);
+            if (threads == 1) {
+                baseline = sample.milliseconds;
+            }
+            const SearchStats& stats = sample.stats;
+            const std::uint64_t probes = stats.tableHits + stats.tableMisses;
+            std::printf("%-6s %7u %10.1f %12llu %10.2f %7.2fx %6.2f %6.1f %6d\n",
+                        describeMode(mode),
+                        threads,
+                        sample.milliseconds,
+                        static_cast<unsigned long long>(stats.nodes),
+                        sample.milliseconds > 0.0 ? static_cast<double>(stats.nodes) / sample.milliseconds / 1000.0 : 0.0,
+                        sample.milliseconds > 0.0 ? baseline / sample.milliseconds : 0.0,
+                        stats.branchingFactor(),
+                        probes > 0 ? 100.0 * static_cast<double>(stats.tableHits) / static_cast<double>(probes) : 0.0,
+                        sample.move);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    unsigned maxThreads = 0;
+    unsigned repeat = 3;
+    std::vector<ParallelMode> modes = {ParallelMode::ROOT_SPLIT, ParallelMode::LAZY_SMP};
+
+    for (int i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+        if (std::strcmp(option, "--help") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        const char* value = argv[++i];
+        bool ok = true;
+        if (std::strcmp(option, "--threads") == 0) {
+            ok = parseUnsigned(value, maxThreads);
+        } else if (std::strcmp(option, "--repeat") == 0) {
+            ok = parseUnsigned(value, repeat) && repeat > 0;
+        } else if (std::strcmp(option, "--mode") == 0) {
+            if (std::strcmp(value, "root") == 0) {
+                modes = {ParallelMode::ROOT_SPLIT};
+            } else if (std::strcmp(value, "lazy") == 0) {
+                modes = {ParallelMode::LAZY_SMP};
+            } else {
+                ok = std::strcmp(value, "both") == 0;
+            }
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::fprintf(stderr, "Invalid argument: %s %s\n", option, value);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (maxThreads == 0) {
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Exact solves from a cold table
+    std::printf("Search scaling, 1 to %u threads, fastest of %u runs\n", maxThreads, repeat);
+    report<GameEngine4x4>("4x4, empty board", {}, maxThreads, modes, repeat);
+    report<GameEngine5x5>("5x5 four in a row, 8 stones", {12, 6, 0, 24, 18, 8, 16, 4}, maxThreads, modes, repeat);
+    return 0;
+}
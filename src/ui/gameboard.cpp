@@ -10,6 +10,7 @@ GameBoard::GameBoard(QWidget* parent)
     : QWidget(parent)
     , ui_(std::make_unique<Ui::GameBoard>())
     , gameEngine_(nullptr)
+    , batcher_(nullptr)
 {
     ui_->setupUi(this);
     setupBoard();
@@ -40,8 +41,8 @@ void GameBoard::updateBoard()
     }
 
     const auto& board = gameEngine_->getBoard();
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < GameEngine::kBoardSize; ++i) {
+        for (int j = 0; j < GameEngine::kBoardSize; ++j) {
             updateCellStyle(cells_[i][j], board[i][j]);
         }
     }
@@ -52,8 +53,8 @@ void GameBoard::setupBoard()
     auto layout = new QGridLayout(this);
     layout->setSpacing(5);
 
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < GameEngine::kBoardSize; ++i) {
+        for (int j = 0; j < GameEngine::kBoardSize; ++j) {
             auto button = new QPushButton(this);
             button->setFixedSize(100, 100);
             button->setFont(QFont("Arial", 24, QFont::Bold));
@@ -69,19 +70,25 @@ void GameBoard::setupBoard()
 
 void GameBoard::setupConnections()
 {
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < GameEngine::kBoardSize; ++i) {
+        for (int j = 0; j < GameEngine::kBoardSize; ++j) {
             connect(cells_[i][j], &QPushButton::clicked,
                     this, &GameBoard::onCellClicked);
         }
     }
 
-    connect(gameEngine_, &GameEngine::gameStateChanged,
-            this, &GameBoard::onGameStateChanged);
-    connect(gameEngine_, &GameEngine::currentPlayerChanged,
-            this, &GameBoard::onCurrentPlayerChanged);
-    connect(gameEngine_, &GameEngine::boardChanged,
-            this, &GameBoard::onBoardChanged);
+    // Cells are restyled from batched deltas, so a burst of moves costs
+    // one pass over only the cells that changed
+    delete batcher_;
+    batcher_ = new MoveDeltaBatcher(gameEngine_, this);
+    connect(batcher_, &MoveDeltaBatcher::movesApplied,
+            this, &GameBoard::onMovesApplied);
+    connect(gameEngine_, &GameEngine::gameReset,
+            this, &GameBoard::onGameReset);
+
+    // No clicks while the AI searches; the event loop keeps running
+    connect(gameEngine_, &GameEngine::aiThinkingChanged,
+            this, &GameBoard::onAIThinkingChanged);
 }
 
 void GameBoard::updateCellStyle(QPushButton* button, Player player)
@@ -110,8 +117,8 @@ void GameBoard::updateCellStyle(QPushButton* button, Player player)
 
 void GameBoard::disableBoard()
 {
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < GameEngine::kBoardSize; ++i) {
+        for (int j = 0; j < GameEngine::kBoardSize; ++j) {
             cells_[i][j]->setEnabled(false);
         }
     }
@@ -119,8 +126,8 @@ void GameBoard::disableBoard()
 
 void GameBoard::enableBoard()
 {
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < GameEngine::kBoardSize; ++i) {
+        for (int j = 0; j < GameEngine::kBoardSize; ++j) {
             cells_[i][j]->setEnabled(true);
         }
     }
@@ -152,24 +159,41 @@ void GameBoard::onCellClicked()
     }
 }
 
-void GameBoard::onGameStateChanged(GameState newState)
+void GameBoard::onMovesApplied(const QVector<MoveDelta>& deltas)
 {
-    if (newState != GameState::IN_PROGRESS) {
+    for (const auto& delta : deltas) {
+        updateCellStyle(cells_[delta.cell / GameEngine::kBoardSize][delta.cell % GameEngine::kBoardSize],
+                        delta.player);
+    }
+
+    const MoveDelta& last = deltas.back();
+    if (last.state != GameState::IN_PROGRESS) {
         disableBoard();
-    } else {
-        enableBoard();
+        return;
+    }
+    // The human's move has already started the AI's search, which owns the
+    // label until onAIThinkingChanged() hands it back
+    if (!gameEngine_->isAIThinking()) {
+        ui_->currentPlayerLabel->setText("Current player: " + getPlayerSymbol(last.nextPlayer));
     }
 }
 
-void GameBoard::onCurrentPlayerChanged(Player newPlayer)
+void GameBoard::onGameReset()
 {
-    // Update UI to show current player
-    ui_->currentPlayerLabel->setText("Current player: " + getPlayerSymbol(newPlayer));
+    updateBoard();
+    enableBoard();
+    ui_->currentPlayerLabel->setText("Current player: " + getPlayerSymbol(gameEngine_->getCurrentPlayer()));
 }
 
-void GameBoard::onBoardChanged()
+void GameBoard::onAIThinkingChanged(bool thinking)
 {
-    updateBoard();
+    if (thinking) {
+        disableBoard();
+        ui_->currentPlayerLabel->setText("AI is thinking...");
+    } else if (!gameEngine_->isGameOver()) {
+        enableBoard();
+        ui_->currentPlayerLabel->setText("Current player: " + getPlayerSymbol(gameEngine_->getCurrentPlayer()));
+    }
 }
 
 } // namespace tictactoe 
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "ui_mainwindow.h"
 #include "ui/loginwindow.h"
 #include "ui/gameboard.h"
+#include <QCloseEvent>
 #include <QMessageBox>
 #include <QDateTime>
 
@@ -29,15 +30,20 @@ MainWindow::~MainWindow() = default;
 
 void MainWindow::setupConnections()
 {
-    // Game engine connections
-    connect(gameEngine_.get(), &GameEngine::gameStateChanged,
-            this, &MainWindow::onGameStateChanged);
-    connect(gameEngine_.get(), &GameEngine::currentPlayerChanged,
-            this, &MainWindow::onCurrentPlayerChanged);
-    connect(gameEngine_.get(), &GameEngine::boardChanged,
-            this, &MainWindow::onBoardChanged);
-    connect(gameEngine_.get(), &GameEngine::gameOver,
-            this, &MainWindow::onGameOver);
+    // Game engine connections: one status update per burst of moves
+    auto batcher = new MoveDeltaBatcher(gameEngine_.get(), this);
+    connect(batcher, &MoveDeltaBatcher::movesApplied,
+            this, &MainWindow::onMovesApplied);
+    connect(gameEngine_.get(), &GameEngine::gameReset,
+            this, &MainWindow::onGameReset);
+    connect(gameEngine_.get(), &GameEngine::aiThinkingChanged,
+            this, &MainWindow::onAIThinkingChanged);
+
+    // Menu actions
+    connect(ui_->actionNewGame, &QAction::triggered,
+            gameEngine_.get(), &GameEngine::resetGame);
+    connect(ui_->actionVsAI, &QAction::toggled,
+            gameEngine_.get(), &GameEngine::setGameMode);
 
     // User manager connections
     connect(userManager_.get(), &UserManager::userLoggedIn,
@@ -63,7 +69,7 @@ void MainWindow::updateUI()
     QString status;
     switch (gameEngine_->getGameState()) {
         case GameState::IN_PROGRESS:
-            status = "Current player: " + QString(getCurrentPlayer() == Player::X ? "X" : "O");
+            status = "Current player: " + QString(gameEngine_->getCurrentPlayer() == Player::X ? "X" : "O");
             break;
         case GameState::X_WON:
             status = "Player X won!";
@@ -74,6 +80,8 @@ void MainWindow::updateUI()
         case GameState::DRAW:
             status = "Game ended in a draw!";
             break;
+        case GameState::NONE:
+            break;
     }
     ui_->statusLabel->setText(status);
 }
@@ -139,25 +147,42 @@ void MainWindow::saveGameState()
     dbManager_->saveGameRecord(record);
 }
 
-void MainWindow::onGameStateChanged(GameState newState)
+void MainWindow::onMovesApplied(const QVector<MoveDelta>& deltas)
 {
-    updateUI();
-    if (newState != GameState::IN_PROGRESS) {
+    // Keep "AI is thinking..." up if the batch arrives after the search began
+    if (!gameEngine_->isAIThinking()) {
+        updateUI();
+    }
+
+    const GameState finalState = deltas.back().state;
+    if (finalState != GameState::IN_PROGRESS) {
         saveGameState();
+        showGameOver(finalState);
     }
 }
 
-void MainWindow::onCurrentPlayerChanged(Player newPlayer)
+void MainWindow::onGameReset()
 {
     updateUI();
 }
 
-void MainWindow::onBoardChanged()
+void MainWindow::onAIThinkingChanged(bool thinking)
 {
-    updateUI();
+    if (thinking) {
+        ui_->statusLabel->setText("AI is thinking...");
+    } else {
+        updateUI();
+    }
+}
+
+void MainWindow::closeEvent(QCloseEvent* event)
+{
+    // Stop the AI before the window and its engine are torn down
+    gameEngine_->cancelAIMove();
+    QMainWindow::closeEvent(event);
 }
 
-void MainWindow::onGameOver(GameState finalState)
+void MainWindow::showGameOver(GameState finalState)
 {
     QString message;
     switch (finalState) {
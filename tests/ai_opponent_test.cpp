@@ -1,5 +1,10 @@
 #include <gtest/gtest.h>
 #include "game/ai_opponent.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
 
 namespace tictactoe {
 namespace test {
@@ -133,5 +138,325 @@ TEST_F(AIOpponentTest, EvaluateBoard) {
     EXPECT_EQ(ai->evaluateBoard(board, Player::X), 10);
 }
 
+namespace {
+
+// Exhaustive minimax without pruning or tables: score for the side to move
+template <typename Engine>
+int referenceScore(Engine& engine, int ply)
+{
+    int best = -1000000;
+    auto moves = engine.getLegalMoves();
+    while (!isEmptyMask(moves)) {
+        engine.makeMove(popLowestCell(moves));
+        int score = 0;
+        if (engine.getGameState() == GameState::IN_PROGRESS) {
+            score = -referenceScore(engine, ply + 1);
+        } else if (engine.getGameState() != GameState::DRAW) {
+            score = 1000 - ply;
+        }
+        engine.undoMove();
+        best = std::max(best, score);
+    }
+    return best;
+}
+
+// First best root move in centre-distance order
+template <typename Engine>
+int referenceMove(Engine engine)
+{
+    constexpr int kSize = Engine::kSize;
+    std::vector<int> order;
+    for (int cell = 0; cell < Engine::kCells; ++cell) {
+        order.push_back(cell);
+    }
+    std::stable_sort(order.begin(), order.end(), [](int a, int b) {
+        auto distance = [](int cell) {
+            return std::abs(2 * (cell / kSize) - (kSize - 1)) + std::abs(2 * (cell % kSize) - (kSize - 1));
+        };
+        return distance(a) < distance(b);
+    });
+
+    int bestScore = -1000000;
+    int bestMove = -1;
+    for (const int cell : order) {
+        if (!engine.makeMove(cell)) {
+            continue;
+        }
+        int score = 0;
+        if (engine.getGameState() == GameState::IN_PROGRESS) {
+            score = -referenceScore(engine, 1);
+        } else if (engine.getGameState() != GameState::DRAW) {
+            score = 1000;
+        }
+        engine.undoMove();
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = cell;
+        }
+    }
+    return bestMove;
+}
+
+} // namespace
+
+TEST(AIOpponentSearchTest, MatchesExhaustiveMinimax) {
+    BasicAIOpponent<GameEngine4x4> ai;
+    std::mt19937_64 rng(11);
+    for (int game = 0; game < 20; ++game) {
+        GameEngine4x4 engine;
+        while (!engine.isGameOver()) {
+            if (engine.getMoveCount() >= 9) {
+                EXPECT_EQ(ai.calculateBestMove(engine), referenceMove(engine));
+                EXPECT_GT(ai.getNodeCount(), 0u);
+            }
+            auto legal = engine.getLegalMoves();
+            for (std::uint64_t skip = rng() % cellCount(legal); skip > 0; --skip) {
+                popLowestCell(legal);
+            }
+            engine.makeMove(lowestCell(legal));
+        }
+    }
+}
+
+TEST(AIOpponentSearchTest, EngineOverloadMatchesBoardOverload) {
+    GameEngine4x4 engine;
+    for (const int cell : {0, 5, 10, 15, 1, 6}) {
+        engine.makeMove(cell);
+    }
+    BasicAIOpponent<GameEngine4x4> ai;
+    const auto move = ai.calculateBestMove(engine.getBoard(), engine.getCurrentPlayer());
+    EXPECT_EQ(ai.calculateBestMove(engine), move.first * 4 + move.second);
+
+    engine.resetGame();
+    for (const int cell : {0, 4, 1, 5, 2, 6, 3}) {
+        engine.makeMove(cell);
+    }
+    EXPECT_EQ(ai.calculateBestMove(engine), -1);
+}
+
+TEST(AIOpponentSearchTest, DeepeningFindsExactScore) {
+    // With a budget that is never reached, iterative deepening must end on
+    // a move as good as the exact solve's
+    BasicAIOpponent<GameEngine4x4> ai;
+    SearchLimits limits;
+    limits.moveTime = std::chrono::milliseconds(10000);
+    ai.setSearchLimits(limits);
+
+    std::mt19937_64 rng(5);
+    for (int game = 0; game < 10; ++game) {
+        GameEngine4x4 engine;
+        while (!engine.isGameOver()) {
+            if (engine.getMoveCount() >= 9) {
+                const int move = ai.calculateBestMove(engine);
+                const int expected = referenceMove(engine);
+
+                auto scoreOf = [&engine](int cell) {
+                    GameEngine4x4 copy = engine;
+                    copy.makeMove(cell);
+                    if (copy.getGameState() == GameState::IN_PROGRESS) {
+                        return -referenceScore(copy, 1);
+                    }
+                    return copy.getGameState() == GameState::DRAW ? 0 : 1000;
+                };
+                EXPECT_EQ(scoreOf(move), scoreOf(expected));
+                EXPECT_GT(ai.getCompletedDepth(), 0);
+            }
+            auto legal = engine.getLegalMoves();
+            for (std::uint64_t skip = rng() % cellCount(legal); skip > 0; --skip) {
+                popLowestCell(legal);
+            }
+            engine.makeMove(lowestCell(legal));
+        }
+    }
+}
+
+TEST(AIOpponentSearchTest, NodeBudget) {
+    GameEngine5x5 engine;
+    engine.makeMove(2, 2);
+    BasicAIOpponent<GameEngine5x5> ai;
+    SearchLimits limits;
+    limits.maxNodes = 5000;
+    ai.setSearchLimits(limits);
+
+    const int move = ai.calculateBestMove(engine);
+    EXPECT_TRUE(hasCell(engine.getLegalMoves(), move));
+    EXPECT_LE(ai.getNodeCount(), limits.maxNodes + GameEngine5x5::kCells);
+    EXPECT_GE(ai.getCompletedDepth(), 1);
+}
+
+TEST(AIOpponentSearchTest, GomokuMoveTime) {
+    // X has an open four on row 7; O to move must block one end
+    GomokuEngine engine;
+    for (int col = 5; col < 8; ++col) {
+        engine.makeMove(7, col);     // X
+        engine.makeMove(0, col * 2); // O, far away
+    }
+    engine.makeMove(7, 8);           // X: four from (7,5) to (7,8)
+
+    BasicAIOpponent<GomokuEngine> ai;
+    SearchLimits limits;
+    limits.moveTime = std::chrono::milliseconds(50);
+    ai.setSearchLimits(limits);
+
+    const auto start = std::chrono::steady_clock::now();
+    const int move = ai.calculateBestMove(engine);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(move == 7 * 15 + 4 || move == 7 * 15 + 9);
+    EXPECT_GE(ai.getCompletedDepth(), 2);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(250));
+}
+
+TEST(AIOpponentSearchTest, DepthLimitTakesWin) {
+    GomokuEngine engine;
+    for (int col = 5; col < 9; ++col) {
+        engine.makeMove(7, col);     // X
+        engine.makeMove(0, col * 2); // O
+    }
+    BasicAIOpponent<GomokuEngine> ai;
+    SearchLimits limits;
+    limits.maxDepth = 1;
+    ai.setSearchLimits(limits);
+
+    const int move = ai.calculateBestMove(engine);
+    EXPECT_TRUE(move == 7 * 15 + 4 || move == 7 * 15 + 9);
+    EXPECT_EQ(ai.getCompletedDepth(), 1);
+}
+
+TEST(AIOpponentSearchTest, ParallelModesMatchSingleThread) {
+    std::mt19937_64 rng(3);
+    for (const ParallelMode mode : {ParallelMode::ROOT_SPLIT, ParallelMode::LAZY_SMP}) {
+        BasicAIOpponent<GameEngine4x4> serial;
+        BasicAIOpponent<GameEngine4x4> parallel;
+        parallel.setThreadCount(4);
+        parallel.setParallelMode(mode);
+        EXPECT_EQ(parallel.getThreadCount(), 4u);
+
+        for (int game = 0; game < 5; ++game) {
+            GameEngine4x4 engine;
+            while (!engine.isGameOver()) {
+                if (engine.getMoveCount() >= 5) {
+                    EXPECT_EQ(parallel.calculateBestMove(engine), serial.calculateBestMove(engine));
+                }
+                auto legal = engine.getLegalMoves();
+                for (std::uint64_t skip = rng() % cellCount(legal); skip > 0; --skip) {
+                    popLowestCell(legal);
+                }
+                engine.makeMove(lowestCell(legal));
+            }
+        }
+    }
+}
+
+TEST(AIOpponentSearchTest, SearchStatsAreReported) {
+    GameEngine4x4 engine;
+    for (const int cell : {5, 0, 10, 15}) {
+        engine.makeMove(cell);
+    }
+
+    BasicAIOpponent<GameEngine4x4> ai;
+    int calls = 0;
+    SearchStats reported;
+    ai.setStatsCallback([&](const SearchStats& stats) {
+        ++calls;
+        reported = stats;
+    });
+    ai.calculateBestMove(engine);
+
+    const SearchStats stats = ai.getSearchStats();
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(reported.nodes, stats.nodes);
+    EXPECT_EQ(stats.nodes, ai.getNodeCount());
+    EXPECT_EQ(stats.completedDepth, 12);
+    EXPECT_GT(stats.maxPly, 0);
+    EXPECT_LT(stats.maxPly, 12);
+    EXPECT_GT(stats.cutoffs, 0u);
+    EXPECT_LE(stats.firstMoveCutoffs, stats.cutoffs);
+    EXPECT_GT(stats.tableHits, 0u);
+    EXPECT_GT(stats.tableMisses, 0u);
+    EXPECT_LE(stats.tableCutoffs, stats.tableHits);
+    // Pruning must leave far fewer than the 12 moves of the root
+    EXPECT_GT(stats.branchingFactor(), 1.0);
+    EXPECT_LT(stats.branchingFactor(), 6.0);
+
+    // A warm table answers the same position with far fewer nodes
+    ai.calculateBestMove(engine);
+    EXPECT_EQ(calls, 2);
+    EXPECT_LT(ai.getSearchStats().nodes, stats.nodes);
+
+    // A finished game is not searched
+    engine.resetGame();
+    for (const int cell : {0, 4, 1, 5, 2, 6, 3}) {
+        engine.makeMove(cell);
+    }
+    ai.calculateBestMove(engine);
+    EXPECT_EQ(calls, 2);
+    EXPECT_EQ(ai.getSearchStats().nodes, 0u);
+}
+
+TEST(AIOpponentSearchTest, QubicThreatSequence) {
+    // X wins by a threat O must block, then two threats at once: five plies,
+    // found by a two-ply search through the threat search at its horizon
+    QubicEngine engine;
+    QubicEngine::Board board{};
+    for (auto& row : board) {
+        row.fill(Player::NONE);
+    }
+    for (const int cell : {23, 26, 27, 58, 59}) {
+        board[cell / 4][cell % 4] = Player::X;
+    }
+    for (const int cell : {0, 36, 46, 53, 62}) {
+        board[cell / 4][cell % 4] = Player::O;
+    }
+    engine.setBoard(board, Player::X);
+    ASSERT_TRUE(isEmptyMask(engine.getThreats(Player::X)));
+
+    BasicAIOpponent<QubicEngine> ai;
+    SearchLimits limits;
+    limits.maxDepth = 2;
+    ai.setSearchLimits(limits);
+    for (int ply = 0; ply < 5 && !engine.isGameOver(); ++ply) {
+        engine.makeMove(ai.calculateBestMove(engine));
+    }
+    EXPECT_EQ(engine.getGameState(), GameState::X_WON);
+}
+
+TEST(AIOpponentSearchTest, QubicBlocksWithinMoveTime) {
+    QubicEngine engine;
+    // X threatens the vertical line through row 1, col 1 of every layer
+    for (const int cell : {5, 0, 21, 1, 37}) {
+        engine.makeMove(cell);
+    }
+    BasicAIOpponent<QubicEngine> ai;
+    SearchLimits limits;
+    limits.moveTime = std::chrono::milliseconds(50);
+    ai.setSearchLimits(limits);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(ai.calculateBestMove(engine), 53);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(250));
+    EXPECT_GE(ai.getCompletedDepth(), 2);
+}
+
+TEST(AIOpponentSearchTest, ParallelMoveTime) {
+    GomokuEngine engine;
+    engine.makeMove(7, 7);
+    for (const ParallelMode mode : {ParallelMode::ROOT_SPLIT, ParallelMode::LAZY_SMP}) {
+        BasicAIOpponent<GomokuEngine> ai;
+        ai.setThreadCount(3);
+        ai.setParallelMode(mode);
+        SearchLimits limits;
+        limits.moveTime = std::chrono::milliseconds(30);
+        ai.setSearchLimits(limits);
+
+        const auto start = std::chrono::steady_clock::now();
+        const int move = ai.calculateBestMove(engine);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_TRUE(hasCell(engine.getLegalMoves(), move));
+        EXPECT_GE(ai.getCompletedDepth(), 1);
+        EXPECT_LT(elapsed, std::chrono::milliseconds(300));
+    }
+}
+
 } // namespace test
-} // namespace tictactoe 
\ No newline at end of file
+} // namespace tictactoe
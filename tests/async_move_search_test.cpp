@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "game/async_move_search.h"
+#include "game/mcts_opponent.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace tictactoe {
+namespace test {
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// A search that will not finish on its own: an exact solve of 15x15
+GomokuEngine openGomoku()
+{
+    GomokuEngine engine;
+    engine.makeMove(112);
+    return engine;
+}
+
+} // namespace
+
+TEST(AsyncMoveSearchTest, MatchesSynchronousSearch) {
+    GameEngine4x4 engine;
+    for (const int cell : {5, 0, 10, 15}) {
+        engine.makeMove(cell);
+    }
+
+    BasicAIOpponent<GameEngine4x4> ai;
+    AsyncMoveSearch<GameEngine4x4> async;
+    auto result = async.start(engine);
+    EXPECT_EQ(result.get(), ai.calculateBestMove(engine));
+    EXPECT_FALSE(async.isSearching());
+}
+
+TEST(AsyncMoveSearchTest, CallbackRunsWithTheMove) {
+    std::mutex mutex;
+    std::condition_variable done;
+    int reported = -2;
+
+    AsyncMoveSearch<ClassicGameEngine> async;
+    ClassicGameEngine engine;
+    engine.makeMove(0);
+    auto result = async.start(engine, [&](int cell) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reported = cell;
+        done.notify_one();
+    });
+
+    const int move = result.get();
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(done.wait_for(lock, 5s, [&] { return reported != -2; }));
+    EXPECT_EQ(reported, move);
+    EXPECT_EQ(move, 4);
+}
+
+TEST(AsyncMoveSearchTest, CancelStopsAnUnboundedSearch) {
+    AsyncMoveSearch<GomokuEngine> async;
+    bool called = false;
+    auto result = async.start(openGomoku(), [&called](int) { called = true; });
+    EXPECT_EQ(result.wait_for(50ms), std::future_status::timeout);
+    EXPECT_TRUE(async.isSearching());
+
+    const auto start = std::chrono::steady_clock::now();
+    async.cancel();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+    EXPECT_EQ(result.get(), -1);
+    EXPECT_FALSE(called);
+
+    // The next search is not affected by the cancelled one
+    SearchLimits limits;
+    limits.maxDepth = 1;
+    async.setSearchLimits(limits);
+    EXPECT_GE(async.start(openGomoku()).get(), 0);
+}
+
+TEST(AsyncMoveSearchTest, StartCancelsThePreviousSearch) {
+    AsyncMoveSearch<GomokuEngine> async;
+    SearchLimits limits;
+    limits.moveTime = 200ms;
+    async.setSearchLimits(limits);
+
+    auto first = async.start(openGomoku());
+    std::this_thread::sleep_for(10ms);
+    auto second = async.start(openGomoku());
+    EXPECT_EQ(first.get(), -1);
+    EXPECT_GE(second.get(), 0);
+}
+
+TEST(AsyncMoveSearchTest, DestructorCancels) {
+    std::future<int> result;
+    {
+        AsyncMoveSearch<GomokuEngine, BasicMCTSOpponent<GomokuEngine>> async;
+        SearchLimits limits;
+        limits.maxNodes = std::uint64_t(1) << 40;
+        async.setSearchLimits(limits);
+        result = async.start(openGomoku());
+        std::this_thread::sleep_for(20ms);
+    }
+    EXPECT_EQ(result.get(), -1);
+}
+
+TEST(AsyncMoveSearchTest, PonderedReplyIsReadyAtOnce) {
+    // Seven empty cells, O to move: the whole ponder finishes quickly
+    GameEngine4x4 engine;
+    for (const int cell : {5, 0, 10, 15, 6, 9, 3, 12, 1}) {
+        engine.makeMove(cell);
+    }
+    ASSERT_EQ(engine.getCurrentPlayer(), Player::O);
+
+    AsyncMoveSearch<GameEngine4x4> async;
+    async.ponder(engine);
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (async.isPondering() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_FALSE(async.isPondering());
+    EXPECT_EQ(async.getPonderedCount(), 7u);
+
+    // Every reply is answered from the ponder, and matches a fresh search
+    for (const int reply : {2, 4, 7}) {
+        engine.makeMove(reply);
+        BasicAIOpponent<GameEngine4x4> fresh;
+        EXPECT_EQ(async.start(engine).get(), fresh.calculateBestMove(engine));
+        engine.undoMove();
+        if (reply != 7) {
+            async.ponder(engine);
+            while (async.isPondering()) {
+                std::this_thread::sleep_for(1ms);
+            }
+        }
+    }
+    EXPECT_EQ(async.getPonderHits(), 3u);
+}
+
+TEST(AsyncMoveSearchTest, StartStopsAPonder) {
+    AsyncMoveSearch<GomokuEngine> async;
+    SearchLimits limits;
+    limits.moveTime = 50ms;
+    async.setSearchLimits(limits);
+
+    // Pondering every reply would take over ten seconds
+    async.ponder(openGomoku());
+    std::this_thread::sleep_for(20ms);
+    EXPECT_TRUE(async.isPondering());
+
+    GomokuEngine engine = openGomoku();
+    engine.makeMove(0);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_GE(async.start(engine).get(), 0);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+    EXPECT_FALSE(async.isPondering());
+    EXPECT_EQ(async.getPonderHits(), 0u);
+}
+
+} // namespace test
+} // namespace tictactoe
@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+#include "game/basic_game_engine.h"
+#include "game/ai_opponent.h"
+#include <random>
+#include <type_traits>
+
+namespace tictactoe {
+namespace test {
+
+TEST(WinLinesTest, LineCounts) {
+    EXPECT_EQ((WinLines<3, 3>::kCount), 8);
+    EXPECT_EQ((WinLines<4, 4>::kCount), 10);
+    EXPECT_EQ((WinLines<5, 4>::kCount), 28);
+    EXPECT_EQ((WinLines<15, 5>::kCount), 572);
+    EXPECT_EQ((WinLines<4, 4, 3>::kCount), 76);
+}
+
+TEST(WinLinesTest, QubicLinesPerCell) {
+    // The 8 corners and the 8 inner cells lie on 7 lines, the rest on 4
+    using Lines = QubicEngine::Lines;
+    int total = 0;
+    for (int cell = 0; cell < QubicEngine::kCells; ++cell) {
+        const int layer = cell / 16;
+        const int row = (cell / 4) % 4;
+        const int col = cell % 4;
+        auto outer = [](int v) { return v == 0 || v == 3; };
+        const bool corner = outer(layer) && outer(row) && outer(col);
+        const bool inner = !outer(layer) && !outer(row) && !outer(col);
+        EXPECT_EQ(Lines::kByCell.counts[cell], (corner || inner) ? 7 : 4) << cell;
+        total += Lines::kByCell.counts[cell];
+    }
+    EXPECT_EQ(total, 76 * 4);
+    static_assert(std::is_same_v<QubicEngine::Mask, std::uint64_t>, "one 64-bit board per player");
+}
+
+TEST(WinLinesTest, ClassicMasks) {
+    static_assert(WinLines<3, 3>::kMasks[0] == 0x007, "first row");
+    static_assert(WinLines<3, 3>::kMasks[3] == 0x049, "first column");
+    static_assert(WinLines<3, 3>::kMasks[6] == 0x111, "diagonal");
+    static_assert(WinLines<3, 3>::kMasks[7] == 0x054, "anti-diagonal");
+    SUCCEED();
+}
+
+TEST(BasicGameEngineTest, FourByFourColumnWin) {
+    GameEngine4x4 engine;
+    for (int row = 0; row < 3; ++row) {
+        EXPECT_TRUE(engine.makeMove(row, 1)); // X
+        EXPECT_TRUE(engine.makeMove(row, 2)); // O
+    }
+    EXPECT_EQ(engine.getGameState(), GameState::IN_PROGRESS);
+    EXPECT_TRUE(engine.makeMove(3, 1)); // X
+    EXPECT_EQ(engine.getGameState(), GameState::X_WON);
+    EXPECT_FALSE(engine.makeMove(3, 2));
+}
+
+TEST(BasicGameEngineTest, FiveByFiveFourInARow) {
+    GameEngine5x5 engine;
+    // O builds the anti-diagonal (0,4) .. (3,1) while X plays the bottom row
+    EXPECT_TRUE(engine.makeMove(4, 0)); // X
+    EXPECT_TRUE(engine.makeMove(0, 4)); // O
+    EXPECT_TRUE(engine.makeMove(4, 1)); // X
+    EXPECT_TRUE(engine.makeMove(1, 3)); // O
+    EXPECT_TRUE(engine.makeMove(4, 2)); // X
+    EXPECT_TRUE(engine.makeMove(2, 2)); // O
+    EXPECT_TRUE(engine.makeMove(2, 0)); // X
+    EXPECT_TRUE(engine.makeMove(3, 1)); // O
+
+    EXPECT_EQ(engine.getGameState(), GameState::O_WON);
+}
+
+TEST(BasicGameEngineTest, GomokuWideBoard) {
+    GomokuEngine engine;
+    EXPECT_EQ(cellCount(engine.getLegalMoves()), 225);
+
+    for (int col = 10; col < 14; ++col) {
+        EXPECT_TRUE(engine.makeMove(14, col)); // X
+        EXPECT_TRUE(engine.makeMove(0, col));  // O
+    }
+    EXPECT_TRUE(engine.makeMove(14, 14)); // X
+    EXPECT_EQ(engine.getGameState(), GameState::X_WON);
+    EXPECT_EQ(engine.getCell(14 * 15 + 14), Player::X);
+    EXPECT_TRUE(isEmptyMask(engine.getLegalMoves()));
+}
+
+TEST(BasicGameEngineTest, SetBoard) {
+    ClassicGameEngine::Board board{};
+    for (auto& row : board) {
+        row.fill(Player::NONE);
+    }
+    board[0][0] = Player::O;
+    board[1][1] = Player::O;
+    board[2][2] = Player::O;
+
+    ClassicGameEngine engine;
+    engine.setBoard(board, Player::X);
+    EXPECT_EQ(engine.getGameState(), GameState::O_WON);
+    EXPECT_EQ(engine.getMoveCount(), 3);
+}
+
+TEST(BasicGameEngineTest, UndoRestoresPosition) {
+    ClassicGameEngine engine;
+    EXPECT_FALSE(engine.undoMove());
+
+    EXPECT_TRUE(engine.makeMove(0, 0)); // X
+    EXPECT_TRUE(engine.makeMove(1, 0)); // O
+    EXPECT_TRUE(engine.makeMove(0, 1)); // X
+    EXPECT_TRUE(engine.makeMove(1, 1)); // O
+    EXPECT_TRUE(engine.makeMove(0, 2)); // X
+    EXPECT_EQ(engine.getGameState(), GameState::X_WON);
+    EXPECT_EQ(engine.getLineCount(0, Player::X), 3);
+
+    EXPECT_TRUE(engine.undoMove());
+    EXPECT_EQ(engine.getGameState(), GameState::IN_PROGRESS);
+    EXPECT_EQ(engine.getCurrentPlayer(), Player::X);
+    EXPECT_EQ(engine.getCell(2), Player::NONE);
+    EXPECT_EQ(engine.getLineCount(0, Player::X), 2);
+    EXPECT_EQ(engine.getLastMove(), 4);
+
+    EXPECT_TRUE(engine.makeMove(1, 2)); // X blocks instead
+    EXPECT_EQ(engine.getGameState(), GameState::IN_PROGRESS);
+    EXPECT_EQ(engine.getCurrentPlayer(), Player::O);
+}
+
+// Incremental line counts must agree with a full scan of the win masks
+TEST(BasicGameEngineTest, IncrementalWinMatchesFullScan) {
+    using Engine = GameEngine5x5;
+    std::mt19937 rng(12345);
+
+    for (int game = 0; game < 200; ++game) {
+        Engine engine;
+        while (!engine.isGameOver()) {
+            auto legal = engine.getLegalMoves();
+            int skip = std::uniform_int_distribution<int>(0, cellCount(legal) - 1)(rng);
+            while (skip-- > 0) {
+                popLowestCell(legal);
+            }
+            const Player mover = engine.getCurrentPlayer();
+            ASSERT_TRUE(engine.makeMove(lowestCell(legal)));
+
+            bool scanned = false;
+            const auto mask = engine.getPlayerMask(mover);
+            for (const auto& line : Engine::Lines::kMasks) {
+                scanned |= (mask & line) == line;
+            }
+            EXPECT_EQ(scanned, engine.getGameState() == GameState::X_WON ||
+                               engine.getGameState() == GameState::O_WON);
+        }
+
+        while (engine.undoMove()) {
+        }
+        EXPECT_EQ(engine.getMoveCount(), 0);
+        for (int line = 0; line < Engine::Lines::kCount; ++line) {
+            EXPECT_EQ(engine.getLineCount(line, Player::X), 0);
+            EXPECT_EQ(engine.getLineCount(line, Player::O), 0);
+        }
+    }
+}
+
+TEST(BasicGameEngineTest, QubicSpaceDiagonal) {
+    QubicEngine engine;
+    // X takes the cube's main diagonal, O the cells beside it
+    for (const int cell : {0, 21, 42}) {
+        EXPECT_TRUE(engine.makeMove(cell));     // X
+        EXPECT_TRUE(engine.makeMove(cell + 1)); // O
+    }
+    EXPECT_EQ(engine.getThreats(Player::X), std::uint64_t{1} << 63);
+    EXPECT_TRUE(engine.makeMove(63));
+    EXPECT_EQ(engine.getGameState(), GameState::X_WON);
+
+    // Rows of the board run through the layers in turn
+    engine.undoMove();
+    const QubicEngine::Board board = engine.getBoard();
+    EXPECT_EQ(board[5][1], Player::X);  // layer 1, row 1, col 1
+    EXPECT_EQ(board[5][2], Player::O);  // layer 1, row 1, col 2
+    EXPECT_TRUE(engine.isValidMove(15, 3));
+    EXPECT_FALSE(engine.isValidMove(16, 0));
+}
+
+// Threats kept up by every move and undo must agree with a full scan
+template <typename Engine>
+void checkThreats(unsigned seed, int games)
+{
+    std::mt19937 rng(seed);
+    for (int game = 0; game < games; ++game) {
+        Engine engine;
+        auto check = [&engine]() {
+            const auto empty = engine.getPlayerMask(Player::NONE);
+            for (const Player player : {Player::X, Player::O}) {
+                const auto own = engine.getPlayerMask(player);
+                const auto other = engine.getPlayerMask(player == Player::X ? Player::O : Player::X);
+                typename Engine::Mask expected{};
+                for (const auto& line : Engine::Lines::kMasks) {
+                    if (isEmptyMask(other & line) && cellCount(own & line) == Engine::kWinLength - 1) {
+                        expected |= static_cast<typename Engine::Mask>(line & empty);
+                    }
+                }
+                ASSERT_TRUE(engine.getThreats(player) == expected);
+            }
+        };
+
+        while (!engine.isGameOver()) {
+            auto legal = engine.getLegalMoves();
+            int skip = std::uniform_int_distribution<int>(0, cellCount(legal) - 1)(rng);
+            while (skip-- > 0) {
+                popLowestCell(legal);
+            }
+            ASSERT_TRUE(engine.makeMove(lowestCell(legal)));
+            check();
+        }
+        while (engine.undoMove()) {
+            check();
+        }
+    }
+}
+
+TEST(BasicGameEngineTest, ThreatsMatchFullScan) {
+    checkThreats<ClassicGameEngine>(1, 50);
+    checkThreats<GameEngine4x4>(2, 50);
+    checkThreats<GameEngine5x5>(3, 50);
+    checkThreats<QubicEngine>(4, 50);
+    checkThreats<GomokuEngine>(5, 3);
+}
+
+TEST(BasicGameEngineTest, PositionKeysFollowTranspositions) {
+    ClassicGameEngine first;
+    ClassicGameEngine second;
+    EXPECT_EQ(first.getZobristKey(), 0u);
+    EXPECT_EQ(first.getPositionIndex(), 0u);
+
+    // Same position through a different move order
+    for (int cell : {0, 4, 8}) {
+        EXPECT_TRUE(first.makeMove(cell));
+    }
+    for (int cell : {8, 4, 0}) {
+        EXPECT_TRUE(second.makeMove(cell));
+    }
+    EXPECT_EQ(first.getZobristKey(), second.getZobristKey());
+    EXPECT_EQ(first.getPositionIndex(), second.getPositionIndex());
+    EXPECT_EQ(first.getPositionIndex(), 1u + 2u * 81u + 1u * 6561u);
+
+    // Rebuilding from the board gives the same identity
+    ClassicGameEngine rebuilt;
+    rebuilt.setBoard(first.getBoard(), first.getCurrentPlayer());
+    EXPECT_EQ(rebuilt.getZobristKey(), first.getZobristKey());
+    EXPECT_EQ(rebuilt.getPositionIndex(), first.getPositionIndex());
+
+    // Side to move is part of the key but not of the index
+    rebuilt.setBoard(first.getBoard(), Player::X);
+    EXPECT_NE(rebuilt.getZobristKey(), first.getZobristKey());
+    EXPECT_EQ(rebuilt.getPositionIndex(), first.getPositionIndex());
+
+    while (first.undoMove()) {
+    }
+    EXPECT_EQ(first.getZobristKey(), 0u);
+    EXPECT_EQ(first.getPositionIndex(), 0u);
+}
+
+TEST(BasicGameEngineTest, GomokuZobristKey) {
+    static_assert(!GomokuEngine::kHasPositionIndex, "3^225 does not fit");
+    static_assert(GameEngine5x5::kHasPositionIndex, "3^25 fits");
+
+    GomokuEngine engine;
+    EXPECT_TRUE(engine.makeMove(7, 7));
+    const auto key = engine.getZobristKey();
+    EXPECT_NE(key, 0u);
+    EXPECT_TRUE(engine.makeMove(7, 8));
+    EXPECT_TRUE(engine.undoMove());
+    EXPECT_EQ(engine.getZobristKey(), key);
+}
+
+TEST(BasicGameEngineTest, FourByFourAIFinishesLine) {
+    GameEngine4x4::Board board{};
+    for (auto& row : board) {
+        row.fill(Player::NONE);
+    }
+    // X completes the bottom row, which also blocks O's diagonal
+    board[0][0] = Player::O;
+    board[0][1] = Player::X;
+    board[0][2] = Player::O;
+    board[1][0] = Player::X;
+    board[1][1] = Player::O;
+    board[1][3] = Player::O;
+    board[2][2] = Player::O;
+    board[3][0] = Player::X;
+    board[3][1] = Player::X;
+    board[3][2] = Player::X;
+
+    BasicAIOpponent<GameEngine4x4> ai;
+    auto move = ai.calculateBestMove(board, Player::X);
+    EXPECT_EQ(move.first, 3);
+    EXPECT_EQ(move.second, 3);
+}
+
+} // namespace test
+} // namespace tictactoe
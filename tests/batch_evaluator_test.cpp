@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "game/batch_evaluator.h"
+#include "game/ai_opponent.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace tictactoe {
+namespace test {
+
+namespace {
+
+constexpr SimdLevel kLevels[] = {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2};
+
+// Random stones for both sides; lines for both, and unreachable stone
+// counts, are allowed
+template <typename Engine>
+typename BatchEvaluator<Engine>::Batch randomBoards(std::size_t count, std::uint64_t seed)
+{
+    using Mask = typename Engine::Mask;
+    std::mt19937_64 rng(seed);
+    typename BatchEvaluator<Engine>::Batch boards;
+    boards.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        // The fill varies per board so that full boards show up too
+        const int fill = std::uniform_int_distribution<int>(0, 100)(rng);
+        Mask x{};
+        Mask o{};
+        for (int cell = 0; cell < Engine::kCells; ++cell) {
+            const int roll = std::uniform_int_distribution<int>(0, 99)(rng);
+            if (roll < fill / 2) {
+                x |= maskOf<Mask>(cell);
+            } else if (roll < fill) {
+                o |= maskOf<Mask>(cell);
+            }
+        }
+        boards.add(x, o);
+    }
+    return boards;
+}
+
+template <typename Engine>
+GameState referenceState(typename Engine::Mask x, typename Engine::Mask o)
+{
+    for (const auto& line : Engine::Lines::kMasks) {
+        if ((x & line) == line) {
+            return GameState::X_WON;
+        }
+    }
+    for (const auto& line : Engine::Lines::kMasks) {
+        if ((o & line) == line) {
+            return GameState::O_WON;
+        }
+    }
+    return ((x | o) == Engine::kFullBoard) ? GameState::DRAW : GameState::IN_PROGRESS;
+}
+
+template <typename Engine>
+void checkAllLevels(std::size_t count)
+{
+    const auto boards = randomBoards<Engine>(count, 99 + count);
+    for (const SimdLevel level : kLevels) {
+        const BatchEvaluator<Engine> evaluator(level);
+        std::vector<GameState> states(count);
+        std::vector<std::int8_t> scores(count);
+        evaluator.evaluate(boards, states.data(), scores.data());
+        for (std::size_t i = 0; i < count; ++i) {
+            const GameState expected = referenceState<Engine>(boards.getX(i), boards.getO(i));
+            ASSERT_EQ(states[i], expected) << describeSimdLevel(evaluator.getSimdLevel()) << " board " << i;
+            const int score = (expected == GameState::X_WON) ? 10 : ((expected == GameState::O_WON) ? -10 : 0);
+            ASSERT_EQ(scores[i], score);
+        }
+    }
+}
+
+} // namespace
+
+TEST(BatchEvaluatorTest, AllBoardSizesMatchReference) {
+    // Counts that leave partial vectors and partial chunks
+    for (const std::size_t count : {std::size_t(1), std::size_t(7), std::size_t(37), std::size_t(1000)}) {
+        checkAllLevels<ClassicGameEngine>(count);
+        checkAllLevels<GameEngine4x4>(count);
+        checkAllLevels<GameEngine5x5>(count);
+        checkAllLevels<GomokuEngine>(count);
+    }
+}
+
+TEST(BatchEvaluatorTest, MatchesEvaluateBoardOnEveryClassicBoard) {
+    // Every assignment of the 9 cells
+    using Mask = ClassicGameEngine::Mask;
+    ClassicBatchEvaluator::Batch boards;
+    for (int index = 0; index < 19683; ++index) {
+        Mask x{};
+        Mask o{};
+        int rest = index;
+        for (int cell = 0; cell < 9; ++cell, rest /= 3) {
+            if (rest % 3 == 1) {
+                x |= maskOf<Mask>(cell);
+            } else if (rest % 3 == 2) {
+                o |= maskOf<Mask>(cell);
+            }
+        }
+        boards.add(x, o);
+    }
+
+    const ClassicBatchEvaluator evaluator;
+    std::vector<std::int8_t> scores(boards.size());
+    evaluator.evaluate(boards, nullptr, scores.data());
+
+    AIOpponent ai;
+    for (std::size_t i = 0; i < boards.size(); ++i) {
+        const Mask x = boards.getX(i);
+        const Mask o = boards.getO(i);
+        ClassicGameEngine::Board board{};
+        for (int cell = 0; cell < 9; ++cell) {
+            board[cell / 3][cell % 3] = hasCell(x, cell) ? Player::X
+                                      : hasCell(o, cell) ? Player::O
+                                                         : Player::NONE;
+        }
+        // evaluateBoard reports the first line it finds; only boards with
+        // lines for one side are comparable
+        const bool both = referenceState<ClassicGameEngine>(x, o) == GameState::X_WON &&
+                          std::any_of(ClassicGameEngine::Lines::kMasks.begin(), ClassicGameEngine::Lines::kMasks.end(),
+                                      [&](Mask line) { return (o & line) == line; });
+        if (!both) {
+            ASSERT_EQ(scores[i], ai.evaluateBoard(board, Player::X)) << i;
+        }
+    }
+}
+
+TEST(BatchEvaluatorTest, PackMatchesEngine) {
+    GameEngine5x5 engine;
+    for (const int cell : {12, 0, 13, 1, 14, 2, 11}) {
+        engine.makeMove(cell);
+    }
+    BatchEvaluator<GameEngine5x5>::Batch boards;
+    BatchEvaluator<GameEngine5x5>::pack(engine, boards);
+    ASSERT_EQ(boards.size(), 1u);
+    EXPECT_EQ(boards.getX(0), engine.getPlayerMask(Player::X));
+    EXPECT_EQ(boards.getO(0), engine.getPlayerMask(Player::O));
+    GameState state;
+    BatchEvaluator<GameEngine5x5>().evaluate(boards, &state, nullptr);
+    EXPECT_EQ(state, GameState::X_WON);
+    EXPECT_EQ(state, engine.getGameState());
+}
+
+TEST(BatchEvaluatorTest, LevelIsCappedByHardwareAndBoard) {
+    EXPECT_LE(ClassicBatchEvaluator(SimdLevel::AVX2).getSimdLevel(), detectSimdLevel());
+    EXPECT_EQ(ClassicBatchEvaluator(SimdLevel::SCALAR).getSimdLevel(), SimdLevel::SCALAR);
+    EXPECT_EQ(BatchEvaluator<GomokuEngine>(SimdLevel::AVX2).getSimdLevel(), SimdLevel::SCALAR);
+}
+
+} // namespace test
+} // namespace tictactoe
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "game/classic_solution.h"
+#include "game/ai_opponent.h"
+#include <cstdlib>
+#include <set>
+
+namespace tictactoe {
+namespace test {
+
+namespace {
+
+// Plain negamax on the engine, scored like the table
+int solve(ClassicGameEngine& engine)
+{
+    if (engine.getGameState() == GameState::DRAW) {
+        return 0;
+    }
+    if (engine.isGameOver()) {
+        return -10;
+    }
+    int best = -128;
+    auto moves = engine.getLegalMoves();
+    while (moves != 0) {
+        engine.makeMove(popLowestCell(moves));
+        int score = -solve(engine);
+        engine.undoMove();
+        score += (score > 0) ? -1 : ((score < 0) ? 1 : 0);
+        best = std::max(best, score);
+    }
+    return best;
+}
+
+int centreDistance(int cell)
+{
+    return std::abs(2 * (cell / 3) - 2) + std::abs(2 * (cell % 3) - 2);
+}
+
+void checkPositions(ClassicGameEngine& engine, std::set<std::uint64_t>& seen)
+{
+    if (!seen.insert(engine.getPositionIndex()).second) {
+        return;
+    }
+
+    const ClassicSolution::Entry entry = ClassicSolution::lookup(engine);
+    EXPECT_EQ(entry.score, solve(engine));
+    if (engine.isGameOver()) {
+        EXPECT_EQ(entry.move, -1);
+        return;
+    }
+
+    // The move reaches the score, and no nearer-centre move does
+    ASSERT_TRUE(engine.isValidMove(entry.move / 3, entry.move % 3));
+    auto moves = engine.getLegalMoves();
+    while (moves != 0) {
+        const int cell = popLowestCell(moves);
+        engine.makeMove(cell);
+        int score = -ClassicSolution::lookup(engine).score;
+        score += (score > 0) ? -1 : ((score < 0) ? 1 : 0);
+        if (cell == entry.move) {
+            EXPECT_EQ(score, entry.score);
+        } else if (centreDistance(cell) < centreDistance(entry.move) ||
+                   (centreDistance(cell) == centreDistance(entry.move) && cell < entry.move)) {
+            EXPECT_LT(score, entry.score);
+        }
+        checkPositions(engine, seen);
+        engine.undoMove();
+    }
+}
+
+} // namespace
+
+TEST(ClassicSolutionTest, EmptyBoard) {
+    const auto entry = ClassicSolution::lookup(ClassicGameEngine{});
+    EXPECT_EQ(entry.move, 4);
+    EXPECT_EQ(entry.score, 0);
+}
+
+TEST(ClassicSolutionTest, MatchesFullSearch) {
+    ClassicGameEngine engine;
+    std::set<std::uint64_t> seen;
+    checkPositions(engine, seen);
+    EXPECT_EQ(seen.size(), 5478u);
+}
+
+TEST(ClassicSolutionTest, IllegalCountsHaveNoMove) {
+    // Two X stones and no O stones
+    const std::uint64_t index = 1 + 3;
+    EXPECT_EQ(ClassicSolution::lookup(index).move, -1);
+    EXPECT_EQ(ClassicSolution::lookup(ClassicSolution::kPositions).move, -1);
+}
+
+TEST(ClassicSolutionTest, AIAnswersFromTable) {
+    ClassicGameEngine engine;
+    engine.makeMove(0, 0); // X corner
+    AIOpponent ai;
+    const auto move = ai.calculateBestMove(engine.getBoard(), Player::O);
+    const auto entry = ClassicSolution::lookup(engine);
+    EXPECT_EQ(move.first * 3 + move.second, entry.move);
+    EXPECT_EQ(entry.move, 4); // only the centre holds the draw
+    EXPECT_EQ(entry.score, 0);
+
+    // Nothing was searched
+    EXPECT_EQ(ai.getTranspositionTable().getUsage(), 0u);
+}
+
+} // namespace test
+} // namespace tictactoe
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include "game/gameengine.h"
+#include "game/move_delta_batcher.h"
+#include <QCoreApplication>
+#include <QString>
+#include <vector>
 
 namespace tictactoe {
 namespace test {
@@ -50,14 +54,14 @@ TEST_F(GameEngineTest, WinCondition) {
 TEST_F(GameEngineTest, DrawCondition) {
     // Fill the board to create a draw
     EXPECT_TRUE(engine->makeMove(0, 0)); // X
+    EXPECT_TRUE(engine->makeMove(1, 1)); // O
+    EXPECT_TRUE(engine->makeMove(2, 2)); // X
     EXPECT_TRUE(engine->makeMove(0, 1)); // O
+    EXPECT_TRUE(engine->makeMove(2, 1)); // X
+    EXPECT_TRUE(engine->makeMove(2, 0)); // O
     EXPECT_TRUE(engine->makeMove(0, 2)); // X
-    EXPECT_TRUE(engine->makeMove(1, 0)); // O
-    EXPECT_TRUE(engine->makeMove(1, 1)); // X
     EXPECT_TRUE(engine->makeMove(1, 2)); // O
-    EXPECT_TRUE(engine->makeMove(2, 0)); // X
-    EXPECT_TRUE(engine->makeMove(2, 2)); // O
-    EXPECT_TRUE(engine->makeMove(2, 1)); // X
+    EXPECT_TRUE(engine->makeMove(1, 0)); // X
 
     EXPECT_EQ(engine->getGameState(), GameState::DRAW);
     EXPECT_TRUE(engine->isGameOver());
@@ -85,6 +89,85 @@ TEST_F(GameEngineTest, ResetGame) {
     }
 }
 
+TEST_F(GameEngineTest, BitboardMasks) {
+    EXPECT_EQ(engine->getLegalMoves(), 0x1FF);
+
+    EXPECT_TRUE(engine->makeMove(0, 0)); // X
+    EXPECT_TRUE(engine->makeMove(1, 1)); // O
+
+    EXPECT_EQ(engine->getPlayerMask(Player::X), 0x001);
+    EXPECT_EQ(engine->getPlayerMask(Player::O), 0x010);
+    EXPECT_EQ(engine->getLegalMoves(), 0x1EE);
+
+    const auto board = engine->getBoard();
+    EXPECT_EQ(board[0][0], Player::X);
+    EXPECT_EQ(board[1][1], Player::O);
+    EXPECT_EQ(board[2][2], Player::NONE);
+}
+
+TEST_F(GameEngineTest, NoLegalMovesAfterWin) {
+    EXPECT_TRUE(engine->makeMove(0, 2)); // X
+    EXPECT_TRUE(engine->makeMove(0, 0)); // O
+    EXPECT_TRUE(engine->makeMove(1, 1)); // X
+    EXPECT_TRUE(engine->makeMove(0, 1)); // O
+    EXPECT_TRUE(engine->makeMove(2, 0)); // X
+
+    EXPECT_EQ(engine->getGameState(), GameState::X_WON);
+    EXPECT_EQ(engine->getLegalMoves(), 0);
+}
+
+TEST_F(GameEngineTest, OneDeltaPerMove) {
+    std::vector<MoveDelta> deltas;
+    QObject::connect(engine.get(), &GameEngine::moveApplied,
+                     [&deltas](const MoveDelta& delta) { deltas.push_back(delta); });
+
+    EXPECT_TRUE(engine->makeMove(0, 0)); // X
+    EXPECT_FALSE(engine->makeMove(0, 0));
+    ASSERT_EQ(deltas.size(), 1u);
+    EXPECT_EQ(deltas[0].cell, 0);
+    EXPECT_EQ(deltas[0].player, Player::X);
+    EXPECT_EQ(deltas[0].state, GameState::IN_PROGRESS);
+    EXPECT_EQ(deltas[0].nextPlayer, Player::O);
+
+    EXPECT_TRUE(engine->makeMove(1, 0)); // O
+    EXPECT_TRUE(engine->makeMove(0, 1)); // X
+    EXPECT_TRUE(engine->makeMove(1, 1)); // O
+    EXPECT_TRUE(engine->makeMove(0, 2)); // X
+    ASSERT_EQ(deltas.size(), 5u);
+    EXPECT_EQ(deltas.back().cell, 2);
+    EXPECT_EQ(deltas.back().state, GameState::X_WON);
+    EXPECT_EQ(deltas.back().nextPlayer, Player::NONE);
+}
+
+// The human's move is batched before the AI starts, so the flush arrives
+// while the search runs and must not overwrite the thinking status
+TEST_F(GameEngineTest, ThinkingStatusSurvivesTheFlush) {
+    MoveDeltaBatcher batcher(engine.get());
+    QString status;
+    QObject::connect(engine.get(), &GameEngine::aiThinkingChanged, [&status](bool thinking) {
+        if (thinking) {
+            status = "AI is thinking...";
+        }
+    });
+    QObject::connect(&batcher, &MoveDeltaBatcher::movesApplied,
+                     [this, &status](const QVector<MoveDelta>& deltas) {
+        if (!engine->isAIThinking()) {
+            status = QString("Current player: ") + (deltas.back().nextPlayer == Player::X ? "X" : "O");
+        }
+    });
+
+    engine->setPondering(false);
+    engine->setGameMode(true);
+    EXPECT_TRUE(engine->makeMove(0, 0)); // X
+    ASSERT_TRUE(engine->isAIThinking());
+    EXPECT_EQ(status, "AI is thinking...");
+
+    // Deliver only the batch; the AI's reply stays queued on the engine
+    QCoreApplication::sendPostedEvents(&batcher, QEvent::MetaCall);
+    EXPECT_TRUE(engine->isAIThinking());
+    EXPECT_EQ(status, "AI is thinking...");
+}
+
 TEST_F(GameEngineTest, GameMode) {
     EXPECT_FALSE(engine->isVsAI());
     engine->setGameMode(true);
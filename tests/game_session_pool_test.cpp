@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "game/game_session_pool.h"
+
+namespace tictactoe {
+namespace test {
+
+class GameSessionPoolTest : public ::testing::Test {
+protected:
+    GameSessionPool pool;
+};
+
+TEST_F(GameSessionPoolTest, HandlesAreStable) {
+    SessionHandle first = pool.create();
+    SessionHandle second = pool.create();
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_TRUE(pool.makeMove(second, 4));
+
+    EXPECT_TRUE(pool.destroy(first));
+    EXPECT_FALSE(pool.isValid(first));
+    EXPECT_EQ(pool.getGameState(first), GameState::NONE);
+    EXPECT_FALSE(pool.makeMove(first, 0));
+    EXPECT_FALSE(pool.destroy(first));
+
+    // The freed slot is reused under a new generation
+    SessionHandle third = pool.create();
+    EXPECT_EQ(third.index, first.index);
+    EXPECT_NE(third, first);
+    EXPECT_TRUE(pool.isValid(second));
+    EXPECT_EQ(pool.getPlayerMask(second, Player::X), 0x010);
+    EXPECT_EQ(pool.getMoveCount(third), 0);
+}
+
+TEST_F(GameSessionPoolTest, StaleHandleGettersDoNotReadReusedSlot) {
+    SessionHandle first = pool.create();
+    EXPECT_TRUE(pool.destroy(first));
+
+    // The new session in the same slot has moves and an AI side of its own
+    SessionHandle reused = pool.create(Player::O);
+    ASSERT_EQ(reused.index, first.index);
+    for (const int cell : {0, 3, 1, 4, 2}) {
+        EXPECT_TRUE(pool.makeMove(reused, cell));
+    }
+    ASSERT_EQ(pool.getGameState(reused), GameState::X_WON);
+
+    for (const SessionHandle handle : {first, SessionHandle{99, 0}}) {
+        EXPECT_EQ(pool.getGameState(handle), GameState::NONE);
+        EXPECT_EQ(pool.getCurrentPlayer(handle), Player::NONE);
+        EXPECT_EQ(pool.getAIPlayer(handle), Player::NONE);
+        EXPECT_EQ(pool.getPlayerMask(handle, Player::X), 0);
+        EXPECT_EQ(pool.getPlayerMask(handle, Player::O), 0);
+        EXPECT_EQ(pool.getMoveCount(handle), -1);
+    }
+}
+
+TEST_F(GameSessionPoolTest, MovesAndResults) {
+    SessionHandle game = pool.create();
+    EXPECT_TRUE(pool.makeMove(game, 0)); // X
+    EXPECT_FALSE(pool.makeMove(game, 0));
+    EXPECT_TRUE(pool.makeMove(game, 3)); // O
+    EXPECT_TRUE(pool.makeMove(game, 1)); // X
+    EXPECT_TRUE(pool.makeMove(game, 4)); // O
+    EXPECT_TRUE(pool.makeMove(game, 2)); // X
+    EXPECT_EQ(pool.getGameState(game), GameState::X_WON);
+    EXPECT_FALSE(pool.makeMove(game, 8));
+
+    EXPECT_TRUE(pool.reset(game));
+    EXPECT_EQ(pool.getGameState(game), GameState::IN_PROGRESS);
+    EXPECT_EQ(pool.getCurrentPlayer(game), Player::X);
+}
+
+TEST_F(GameSessionPoolTest, AdvanceOnlySessionsWhereAIIsToMove) {
+    std::vector<SessionHandle> aiAsO;
+    for (int i = 0; i < 100; ++i) {
+        aiAsO.push_back(pool.create(Player::O));
+    }
+    SessionHandle human = pool.create();
+
+    // X has not moved yet anywhere, so nothing is due
+    EXPECT_EQ(pool.advanceAI([](const auto&, const auto&, Player) { return 0; }), 0u);
+
+    for (const auto& handle : aiAsO) {
+        EXPECT_TRUE(pool.makeMove(handle, 0));
+    }
+    AIOpponent ai;
+    EXPECT_EQ(pool.advanceAI(ai), 100u);
+    for (const auto& handle : aiAsO) {
+        // The only reply to a corner that does not lose is the centre
+        EXPECT_EQ(pool.getPlayerMask(handle, Player::O), 0x010);
+        EXPECT_EQ(pool.getCurrentPlayer(handle), Player::X);
+    }
+    EXPECT_EQ(pool.getMoveCount(human), 0);
+}
+
+// The pool must agree with the engine on every random game
+TEST_F(GameSessionPoolTest, MatchesEngine) {
+    SessionHandle handle = pool.create();
+    unsigned seed = 1;
+    for (int game = 0; game < 500; ++game) {
+        ClassicGameEngine engine;
+        pool.reset(handle);
+        while (!engine.isGameOver()) {
+            seed = seed * 1103515245u + 12345u;
+            auto legal = engine.getLegalMoves();
+            int skip = static_cast<int>((seed >> 16) % static_cast<unsigned>(cellCount(legal)));
+            while (skip-- > 0) {
+                popLowestCell(legal);
+            }
+            const int cell = lowestCell(legal);
+            EXPECT_TRUE(engine.makeMove(cell));
+            EXPECT_TRUE(pool.makeMove(handle, cell));
+        }
+        EXPECT_EQ(pool.getGameState(handle), engine.getGameState());
+    }
+}
+
+} // namespace test
+} // namespace tictactoe
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include "game/mcts_opponent.h"
+#include <chrono>
+#include <cstdint>
+
+namespace tictactoe {
+namespace test {
+
+namespace {
+
+SearchLimits playoutLimit(std::uint64_t playouts)
+{
+    SearchLimits limits;
+    limits.maxNodes = playouts;
+    return limits;
+}
+
+} // namespace
+
+TEST(NodeArenaTest, AllocatesAlignedAndReuses) {
+    NodeArena arena(256);
+    auto* a = arena.create<std::uint8_t>(1);
+    auto* b = arena.create<std::uint64_t>(2);
+    EXPECT_EQ(*a, 1);
+    EXPECT_EQ(*b, 2u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % alignof(std::uint64_t), 0u);
+
+    // Larger than a block: gets a block of its own
+    auto* big = arena.createArray<std::uint32_t>(1000);
+    EXPECT_EQ(big[999], 0u);
+    const std::size_t reserved = arena.getBytesReserved();
+    EXPECT_GE(reserved, 256u + 4000u);
+
+    // After a reset the same blocks serve the same requests
+    arena.reset();
+    EXPECT_EQ(arena.getBytesUsed(), 0u);
+    arena.create<std::uint8_t>(1);
+    arena.create<std::uint64_t>(2);
+    arena.createArray<std::uint32_t>(1000);
+    EXPECT_EQ(arena.getBytesReserved(), reserved);
+}
+
+TEST(MCTSOpponentTest, TakesWinAndBlocks) {
+    MCTSOpponent mcts;
+    mcts.setSearchLimits(playoutLimit(3000));
+
+    ClassicGameEngine::Board board{};
+    board[0][0] = Player::X;
+    board[0][1] = Player::X;
+    board[1][0] = Player::O;
+    board[1][1] = Player::O;
+    EXPECT_EQ(mcts.calculateBestMove(board, Player::X), std::make_pair(0, 2));
+    EXPECT_EQ(mcts.calculateBestMove(board, Player::O), std::make_pair(1, 2));
+
+    board[1][1] = Player::NONE;
+    board[2][2] = Player::O;
+    EXPECT_EQ(mcts.calculateBestMove(board, Player::O), std::make_pair(0, 2));
+    EXPECT_EQ(mcts.getPlayoutCount(), 3000u);
+}
+
+TEST(MCTSOpponentTest, FinishedBoardAnswerMatchesAIOpponent) {
+    // X has the bottom row; the corner 0 and the centre are both empty
+    ClassicGameEngine::Board board{};
+    board[2][0] = Player::X;
+    board[2][1] = Player::X;
+    board[2][2] = Player::X;
+    board[0][1] = Player::O;
+    board[1][0] = Player::O;
+
+    MCTSOpponent mcts;
+    AIOpponent minimax;
+    for (const Player player : {Player::X, Player::O}) {
+        const auto move = mcts.calculateBestMove(board, player);
+        EXPECT_EQ(move, minimax.calculateBestMove(board, player));
+        EXPECT_EQ(move, std::make_pair(1, 1));
+    }
+}
+
+TEST(MCTSOpponentTest, BothRulesHoldTheDrawAgainstPerfectPlay) {
+    for (const SelectionRule rule : {SelectionRule::UCT, SelectionRule::PUCT}) {
+        MCTSOpponent mcts;
+        mcts.setSelectionRule(rule);
+        mcts.setSearchLimits(playoutLimit(5000));
+        AIOpponent perfect;
+
+        for (const bool mctsFirst : {true, false}) {
+            ClassicGameEngine engine;
+            while (!engine.isGameOver()) {
+                const bool mctsToMove = (engine.getCurrentPlayer() == Player::X) == mctsFirst;
+                const int cell = mctsToMove ? mcts.calculateBestMove(engine) : perfect.calculateBestMove(engine);
+                ASSERT_TRUE(engine.makeMove(cell));
+            }
+            EXPECT_EQ(engine.getGameState(), GameState::DRAW);
+        }
+    }
+}
+
+TEST(MCTSOpponentTest, ReusesTreeBetweenMoves) {
+    BasicMCTSOpponent<GameEngine5x5> mcts;
+    mcts.setSearchLimits(playoutLimit(4000));
+
+    GameEngine5x5 engine;
+    ASSERT_TRUE(engine.makeMove(mcts.calculateBestMove(engine)));
+    EXPECT_EQ(mcts.getReusedPlayouts(), 0u);
+    const std::size_t firstTree = mcts.getTreeBytes();
+    EXPECT_GT(firstTree, 0u);
+
+    // Reply with a move the tree has explored
+    ASSERT_TRUE(engine.makeMove(12 == engine.getLastMove() ? 6 : 12));
+    mcts.calculateBestMove(engine);
+    EXPECT_GT(mcts.getReusedPlayouts(), 0u);
+
+    // An unrelated position starts from scratch
+    GameEngine5x5 other;
+    other.makeMove(0);
+    mcts.calculateBestMove(other);
+    EXPECT_EQ(mcts.getReusedPlayouts(), 0u);
+
+    mcts.setTreeReuse(false);
+    other.makeMove(mcts.calculateBestMove(other));
+    other.makeMove(24);
+    mcts.calculateBestMove(other);
+    EXPECT_EQ(mcts.getReusedPlayouts(), 0u);
+}
+
+TEST(MCTSOpponentTest, RootParallelSplitsPlayouts) {
+    BasicMCTSOpponent<GameEngine4x4> mcts;
+    mcts.setThreadCount(3);
+    mcts.setSearchLimits(playoutLimit(3001));
+
+    GameEngine4x4 engine;
+    engine.makeMove(5);
+    engine.makeMove(0);
+    engine.makeMove(6);
+    const int move = mcts.calculateBestMove(engine);
+    EXPECT_TRUE(hasCell(engine.getLegalMoves(), move));
+    EXPECT_EQ(mcts.getPlayoutCount(), 3001u);
+    EXPECT_GT(mcts.getPlayoutsPerSecond(), 0.0);
+}
+
+TEST(MCTSOpponentTest, GomokuMoveTime) {
+    BasicMCTSOpponent<GomokuEngine> mcts;
+    SearchLimits limits;
+    limits.moveTime = std::chrono::milliseconds(50);
+    mcts.setSearchLimits(limits);
+
+    // Four in a row with both ends open: take the fifth
+    GomokuEngine engine;
+    const int xs[] = {112, 113, 114, 115};
+    const int os[] = {0, 30, 60, 90};
+    for (int i = 0; i < 4; ++i) {
+        engine.makeMove(xs[i]);
+        engine.makeMove(os[i]);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const int move = mcts.calculateBestMove(engine);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_TRUE(move == 111 || move == 116);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+    EXPECT_GT(mcts.getPlayoutCount(), 0u);
+}
+
+TEST(MCTSOpponentTest, TreeMemoryLimit) {
+    BasicMCTSOpponent<GameEngine5x5> mcts;
+    mcts.setMaxTreeBytes(0);
+    mcts.setSearchLimits(playoutLimit(2000));
+
+    // Only the root is expanded; every playout starts at one of its children
+    GameEngine5x5 engine;
+    EXPECT_TRUE(hasCell(engine.getLegalMoves(), mcts.calculateBestMove(engine)));
+    EXPECT_LE(mcts.getTreeBytes(), 26 * 64u);
+}
+
+} // namespace test
+} // namespace tictactoe
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include "game/proof_solver.h"
+#include "game/ai_opponent.h"
+#include "game/classic_solution.h"
+#include "game/retrograde_solver.h"
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace tictactoe {
+namespace test {
+
+namespace {
+
+template <typename Engine>
+void playRandomMove(Engine& engine, std::mt19937_64& rng)
+{
+    auto legal = engine.getLegalMoves();
+    for (std::uint64_t skip = rng() % cellCount(legal); skip > 0; --skip) {
+        popLowestCell(legal);
+    }
+    engine.makeMove(lowestCell(legal));
+}
+
+Outcome classicOutcome(const ClassicGameEngine& engine)
+{
+    const int score = ClassicSolution::lookup(engine.getPositionIndex()).score;
+    return score > 0 ? Outcome::WIN : (score < 0 ? Outcome::LOSS : Outcome::DRAW);
+}
+
+// X: 6, 7, 12; O: 0, 4, 24; X to move. X 8 makes an open three on row 1.
+GameEngine5x5 fiveByFiveWin()
+{
+    GameEngine5x5 engine;
+    for (const int cell : {6, 0, 7, 4, 12, 24}) {
+        engine.makeMove(cell);
+    }
+    return engine;
+}
+
+} // namespace
+
+TEST(ProofSolverTest, ClassicMatchesCompileTimeSolution) {
+    ProofSolver solver(1 << 16);
+    std::mt19937_64 rng(11);
+    int compared = 0;
+    for (int game = 0; game < 60; ++game) {
+        ClassicGameEngine engine;
+        while (!engine.isGameOver()) {
+            const Outcome expected = classicOutcome(engine);
+            ASSERT_EQ(solver.solve(engine), expected) << engine.getPositionIndex();
+            ++compared;
+
+            // The proven move keeps the value; a lost position has none
+            const int move = solver.getProvenMove();
+            if (expected == Outcome::LOSS) {
+                EXPECT_EQ(move, -1);
+            } else {
+                ClassicGameEngine child = engine;
+                ASSERT_TRUE(child.makeMove(move));
+                if (!child.isGameOver()) {
+                    EXPECT_EQ(classicOutcome(child), expected == Outcome::WIN ? Outcome::LOSS : Outcome::DRAW);
+                }
+            }
+            playRandomMove(engine, rng);
+        }
+    }
+    EXPECT_GT(compared, 300);
+}
+
+TEST(ProofSolverTest, FourByFourMatchesRetrogradeTable) {
+    const auto table = RetrogradeSolver<GameEngine4x4>::solve();
+    BasicProofSolver<GameEngine4x4> solver(1 << 20);
+    std::mt19937_64 rng(3);
+    for (int game = 0; game < 40; ++game) {
+        GameEngine4x4 engine;
+        for (int ply = 0; ply < 3 + game % 6 && !engine.isGameOver(); ++ply) {
+            playRandomMove(engine, rng);
+        }
+        while (!engine.isGameOver()) {
+            ASSERT_EQ(solver.solve(engine), table.lookup(engine)) << engine.getPositionIndex();
+            playRandomMove(engine, rng);
+        }
+    }
+}
+
+TEST(ProofSolverTest, FinishedGames) {
+    ClassicGameEngine engine;
+    for (const int cell : {0, 3, 1, 4, 2}) {
+        engine.makeMove(cell);
+    }
+    ProofSolver solver;
+    EXPECT_EQ(solver.solve(engine), Outcome::LOSS);
+    EXPECT_EQ(solver.getProvenMove(), -1);
+    EXPECT_EQ(solver.prove(engine, Player::X), ProofResult::PROVEN);
+    EXPECT_EQ(solver.prove(engine, Player::O), ProofResult::DISPROVEN);
+
+    ClassicGameEngine drawn;
+    for (const int cell : {4, 0, 8, 2, 1, 7, 6, 3, 5}) {
+        drawn.makeMove(cell);
+    }
+    ASSERT_EQ(drawn.getGameState(), GameState::DRAW);
+    EXPECT_EQ(solver.solve(drawn), Outcome::DRAW);
+}
+
+TEST(ProofSolverTest, ProvesLargerBoards) {
+    BasicProofSolver<GameEngine5x5> solver(1 << 20);
+    GameEngine5x5 engine = fiveByFiveWin();
+    ASSERT_EQ(solver.solve(engine), Outcome::WIN);
+    const int move = solver.getProvenMove();
+    ASSERT_TRUE(engine.makeMove(move));
+    EXPECT_EQ(solver.solve(engine), Outcome::LOSS);
+
+    // Four in a row on 6x6 is a first-player win
+    BasicProofSolver<GameEngine6x6> sixBySix(1 << 22);
+    EXPECT_EQ(sixBySix.prove(GameEngine6x6(), Player::X), ProofResult::PROVEN);
+    EXPECT_GE(sixBySix.getProvenMove(), 0);
+}
+
+TEST(ProofSolverTest, SmallTableStillProves) {
+    // Four buckets: nearly every result is evicted and searched again
+    BasicProofSolver<GameEngine4x4> solver(0);
+    EXPECT_EQ(solver.getTableCapacity(), 4u);
+    GameEngine4x4 engine;
+    for (const int cell : {5, 0, 6, 15, 9}) {
+        engine.makeMove(cell);
+    }
+    BasicProofSolver<GameEngine4x4> large;
+    const Outcome expected = large.solve(engine);
+    ASSERT_NE(expected, Outcome::UNKNOWN);
+    EXPECT_EQ(solver.solve(engine), expected);
+    EXPECT_LE(solver.getTableUsage(), solver.getTableCapacity());
+    EXPECT_GT(solver.getNodeCount(), large.getNodeCount());
+
+    solver.clearTable();
+    EXPECT_EQ(solver.getTableUsage(), 0u);
+}
+
+TEST(ProofSolverTest, RespectsLimits) {
+    BasicProofSolver<GameEngine5x5> solver(1 << 20);
+    SearchLimits limits;
+    limits.maxNodes = 200;
+    solver.setSearchLimits(limits);
+    EXPECT_EQ(solver.solve(GameEngine5x5()), Outcome::UNKNOWN);
+    EXPECT_EQ(solver.getProvenMove(), -1);
+    EXPECT_LE(solver.getNodeCount(), limits.maxNodes + GameEngine5x5::kCells);
+
+    std::atomic<bool> cancel{true};
+    limits = SearchLimits{};
+    limits.cancel = &cancel;
+    solver.setSearchLimits(limits);
+    EXPECT_EQ(solver.prove(GameEngine5x5(), Player::X), ProofResult::UNKNOWN);
+
+    // Results found before the stop stay in the table
+    solver.setSearchLimits(SearchLimits{});
+    EXPECT_EQ(solver.solve(fiveByFiveWin()), Outcome::WIN);
+}
+
+TEST(ProofSolverTest, ReportsProgress) {
+    BasicProofSolver<GameEngine4x4> solver(1 << 20);
+    std::vector<ProofProgress> reports;
+    solver.setProgressCallback([&](const ProofProgress& progress) {
+        reports.push_back(progress);
+    }, 1000);
+    GameEngine4x4 engine;
+    engine.makeMove(5);
+    ASSERT_EQ(solver.prove(engine, Player::O), ProofResult::DISPROVEN);
+
+    ASSERT_GT(reports.size(), 2u);
+    for (std::size_t i = 1; i < reports.size(); ++i) {
+        EXPECT_GT(reports[i].nodes, reports[i - 1].nodes);
+        EXPECT_EQ(reports[i].attacker, Player::O);
+        EXPECT_LE(reports[i].tableEntries, reports[i].tableCapacity);
+    }
+    EXPECT_EQ(reports.back().disproofNumber, 0u);
+    EXPECT_EQ(reports.back().nodes, solver.getNodeCount());
+    EXPECT_GT(reports.back().tableEntries, 0u);
+}
+
+TEST(ProofSolverTest, AIOpponentPlaysProvenWins) {
+    auto solver = std::make_shared<BasicProofSolver<GameEngine5x5>>(1 << 20);
+    BasicAIOpponent<GameEngine5x5> ai;
+    ai.setProofSolver(solver);
+
+    GameEngine5x5 engine = fiveByFiveWin();
+    const int move = ai.calculateBestMove(engine);
+    EXPECT_EQ(move, solver->getProvenMove());
+    EXPECT_EQ(ai.getSearchStats().proofNodes, solver->getNodeCount());
+    EXPECT_EQ(ai.getSearchStats().nodes, 0u);
+    ASSERT_TRUE(engine.makeMove(move));
+    EXPECT_EQ(solver->solve(engine), Outcome::LOSS);
+
+    // Without a proven win the search runs as before, and its branching
+    // factor counts only its own nodes
+    SearchLimits limits;
+    limits.maxNodes = 100;
+    solver->setSearchLimits(limits);
+    ai.setSearchLimits(limits);
+    EXPECT_GE(ai.calculateBestMove(GameEngine5x5()), 0);
+    const SearchStats& stats = ai.getSearchStats();
+    EXPECT_EQ(stats.proofNodes, solver->getNodeCount());
+    EXPECT_LE(stats.nodes, limits.maxNodes + GameEngine5x5::kCells);
+    ASSERT_GT(stats.expandedNodes, 0u);
+    EXPECT_DOUBLE_EQ(stats.branchingFactor(),
+                     static_cast<double>(stats.nodes) / static_cast<double>(stats.expandedNodes));
+}
+
+TEST(ProofSolverTest, SixBySixAIOpponentPlaysProvenWins) {
+    auto solver = std::make_shared<BasicProofSolver<GameEngine6x6>>(1 << 20);
+    BasicAIOpponent<GameEngine6x6> ai;
+    ai.setProofSolver(solver);
+
+    // X: 14, 15 on row 2; O: 0, 35; X to move. X 13 or 16 makes an open
+    // three that O cannot stop
+    GameEngine6x6 engine;
+    for (const int cell : {14, 0, 15, 35}) {
+        engine.makeMove(cell);
+    }
+    const int move = ai.calculateBestMove(engine);
+    EXPECT_EQ(move, solver->getProvenMove());
+    EXPECT_EQ(ai.getSearchStats().proofNodes, solver->getNodeCount());
+    ASSERT_TRUE(engine.makeMove(move));
+    EXPECT_EQ(solver->solve(engine), Outcome::LOSS);
+
+    // O has no proven win, so the AI searches and answers with a legal move
+    SearchLimits limits;
+    limits.maxNodes = 200;
+    solver->setSearchLimits(limits);
+    ai.setSearchLimits(limits);
+    const int reply = ai.calculateBestMove(engine);
+    EXPECT_TRUE(engine.makeMove(reply));
+}
+
+} // namespace test
+} // namespace tictactoe
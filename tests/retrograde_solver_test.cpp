@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "game/retrograde_solver.h"
+#include "game/ai_opponent.h"
+#include "game/classic_solution.h"
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace tictactoe {
+namespace test {
+
+namespace {
+
+// The 4x4 solve takes a few seconds unoptimized; it is shared by the tests
+std::shared_ptr<const OutcomeTable<GameEngine4x4>> solved4x4()
+{
+    static const auto table =
+        std::make_shared<const OutcomeTable<GameEngine4x4>>(RetrogradeSolver<GameEngine4x4>::solve());
+    return table;
+}
+
+std::string tempPath(const char* name)
+{
+    return std::string(::testing::TempDir()) + name;
+}
+
+} // namespace
+
+TEST(RetrogradeSolverTest, ClassicMatchesCompileTimeSolution) {
+    const OutcomeTable<ClassicGameEngine> table = RetrogradeSolver<ClassicGameEngine>::solve(1);
+    ASSERT_TRUE(table.isLoaded());
+
+    int compared = 0;
+    for (std::uint64_t index = 0; index < ClassicSolution::kPositions; ++index) {
+        const ClassicSolution::Entry entry = ClassicSolution::lookup(index);
+        if (entry.move < 0) {
+            continue;
+        }
+        const Outcome expected = entry.score > 0 ? Outcome::WIN : (entry.score < 0 ? Outcome::LOSS : Outcome::DRAW);
+        ASSERT_EQ(table.get(index), expected) << index;
+        ++compared;
+    }
+    EXPECT_GT(compared, 4000);
+
+    // Every position reachable in play and nothing else: 5478 of them
+    const auto counts = table.countOutcomes();
+    EXPECT_EQ(counts[static_cast<int>(Outcome::WIN)] + counts[static_cast<int>(Outcome::LOSS)] +
+              counts[static_cast<int>(Outcome::DRAW)], 5478u);
+    EXPECT_EQ(table.lookup(ClassicGameEngine()), Outcome::DRAW);
+}
+
+TEST(RetrogradeSolverTest, ThreadCountDoesNotChangeTable) {
+    const auto one = RetrogradeSolver<ClassicGameEngine>::solve(1);
+    const auto three = RetrogradeSolver<ClassicGameEngine>::solve(3);
+    for (std::uint64_t index = 0; index < OutcomeTable<ClassicGameEngine>::kPositions; ++index) {
+        ASSERT_EQ(one.get(index), three.get(index)) << index;
+    }
+}
+
+TEST(RetrogradeSolverTest, LookupChecksSideToMove) {
+    const auto table = RetrogradeSolver<ClassicGameEngine>::solve(1);
+    ClassicGameEngine engine;
+    engine.makeMove(4);
+    EXPECT_EQ(table.lookup(engine), Outcome::DRAW);
+
+    // Same stones with X to move again is not a position of the game
+    ClassicGameEngine::Board board = engine.getBoard();
+    engine.setBoard(board, Player::X);
+    EXPECT_EQ(table.lookup(engine), Outcome::UNKNOWN);
+    EXPECT_EQ(table.bestMove(engine, {0, 1, 2, 3, 4, 5, 6, 7, 8}), -1);
+}
+
+TEST(RetrogradeSolverTest, SaveAndLoad) {
+    const auto table = RetrogradeSolver<ClassicGameEngine>::solve(1);
+    const std::string path = tempPath("classic.outcomes");
+    ASSERT_TRUE(table.save(path));
+
+    OutcomeTable<ClassicGameEngine> loaded;
+    EXPECT_FALSE(loaded.isLoaded());
+    ASSERT_TRUE(loaded.load(path));
+    for (std::uint64_t index = 0; index < OutcomeTable<ClassicGameEngine>::kPositions; ++index) {
+        ASSERT_EQ(loaded.get(index), table.get(index));
+    }
+
+    // A table for another board is refused
+    OutcomeTable<GameEngine4x4> other;
+    EXPECT_FALSE(other.load(path));
+    EXPECT_FALSE(other.isLoaded());
+
+    // So is a truncated file
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    ASSERT_NE(file, nullptr);
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fclose(file);
+    std::vector<char> bytes(static_cast<std::size_t>(size));
+    file = std::fopen(path.c_str(), "rb");
+    ASSERT_EQ(std::fread(bytes.data(), 1, bytes.size(), file), bytes.size());
+    std::fclose(file);
+    file = std::fopen(path.c_str(), "wb");
+    std::fwrite(bytes.data(), 1, bytes.size() - 8, file);
+    std::fclose(file);
+    EXPECT_FALSE(loaded.load(path));
+    EXPECT_FALSE(loaded.isLoaded());
+    EXPECT_FALSE(loaded.load(tempPath("missing.outcomes")));
+    std::remove(path.c_str());
+}
+
+TEST(RetrogradeSolverTest, FourByFourIsADraw) {
+    const auto table = solved4x4();
+    EXPECT_EQ(table->lookup(GameEngine4x4()), Outcome::DRAW);
+
+    // X on three of the top row and O on two cells elsewhere, O to move:
+    // X completes the row next unless O blocks
+    GameEngine4x4 engine;
+    for (const int cell : {0, 5, 1, 10, 2}) {
+        engine.makeMove(cell);
+    }
+    EXPECT_NE(table->lookup(engine), Outcome::UNKNOWN);
+    engine.makeMove(15);
+    EXPECT_EQ(table->lookup(engine), Outcome::WIN);
+}
+
+TEST(RetrogradeSolverTest, AIOpponentAnswersFromTable) {
+    BasicAIOpponent<GameEngine4x4> ai;
+    ai.setOutcomeTable(solved4x4());
+    const auto table = solved4x4();
+
+    // Against random moves the table player never lets a won or drawn
+    // position slip, and answers without searching
+    std::mt19937_64 rng(5);
+    for (int game = 0; game < 20; ++game) {
+        GameEngine4x4 engine;
+        const Player aiSide = (game % 2 == 0) ? Player::X : Player::O;
+        while (!engine.isGameOver()) {
+            if (engine.getCurrentPlayer() == aiSide) {
+                const Outcome before = table->lookup(engine);
+                const int move = ai.calculateBestMove(engine);
+                ASSERT_TRUE(engine.makeMove(move));
+                if (before != Outcome::LOSS) {
+                    EXPECT_EQ(ai.getSearchStats().nodes, 0u);
+                }
+                if (!engine.isGameOver()) {
+                    const Outcome after = table->lookup(engine);
+                    if (before == Outcome::WIN) {
+                        ASSERT_EQ(after, Outcome::LOSS);
+                    } else if (before == Outcome::DRAW) {
+                        ASSERT_NE(after, Outcome::WIN);
+                    }
+                }
+            } else {
+                auto legal = engine.getLegalMoves();
+                for (std::uint64_t skip = rng() % cellCount(legal); skip > 0; --skip) {
+                    popLowestCell(legal);
+                }
+                engine.makeMove(lowestCell(legal));
+            }
+        }
+        const GameState lost = (aiSide == Player::X) ? GameState::O_WON : GameState::X_WON;
+        EXPECT_NE(engine.getGameState(), lost);
+    }
+}
+
+TEST(RetrogradeSolverTest, AIOpponentOpensTablebaseFile) {
+    const std::string path = tempPath("4x4.tablebase");
+    ASSERT_TRUE(solved4x4()->save(path));
+
+    BasicAIOpponent<GameEngine4x4> ai;
+    ASSERT_TRUE(ai.openTablebase(path));
+    GameEngine4x4 engine;
+    const int move = ai.calculateBestMove(engine);
+    EXPECT_EQ(ai.getSearchStats().nodes, 0u);
+    ASSERT_TRUE(engine.makeMove(move));
+    EXPECT_EQ(solved4x4()->lookup(engine), Outcome::DRAW);
+    std::remove(path.c_str());
+}
+
+} // namespace test
+} // namespace tictactoe
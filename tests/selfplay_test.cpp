@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "selfplay/simulator.h"
+
+namespace tictactoe {
+namespace test {
+
+TEST(SelfPlayTest, ParsePolicySpec) {
+    PolicySpec spec;
+    EXPECT_TRUE(parsePolicySpec("perfect", spec));
+    EXPECT_EQ(spec.type, PolicyType::PERFECT);
+    EXPECT_TRUE(parsePolicySpec("epsilon:0.25", spec));
+    EXPECT_EQ(spec.type, PolicyType::EPSILON_GREEDY);
+    EXPECT_DOUBLE_EQ(spec.epsilon, 0.25);
+    EXPECT_FALSE(parsePolicySpec("epsilon:2", spec));
+    EXPECT_TRUE(parsePolicySpec("mcts:500", spec));
+    EXPECT_EQ(spec.type, PolicyType::MCTS);
+    EXPECT_EQ(spec.playouts, 500u);
+    EXPECT_FALSE(parsePolicySpec("mcts:0", spec));
+    EXPECT_FALSE(parsePolicySpec("greedy", spec));
+}
+
+TEST(SelfPlayTest, ResultsIndependentOfThreadCount) {
+    SelfPlayConfig config;
+    config.games = 2000;
+    config.gamesPerTask = 64;
+    config.seed = 7;
+
+    config.threads = 1;
+    const SelfPlayReport single = runSelfPlay(config);
+    config.threads = 4;
+    const SelfPlayReport multi = runSelfPlay(config);
+
+    EXPECT_EQ(single.games, 2000u);
+    EXPECT_EQ(single.xWins + single.oWins + single.draws, 2000u);
+    EXPECT_EQ(single.xWins, multi.xWins);
+    EXPECT_EQ(single.oWins, multi.oWins);
+    EXPECT_EQ(single.draws, multi.draws);
+    EXPECT_EQ(single.moves, single.xLatency.getCount() + single.oLatency.getCount());
+}
+
+TEST(SelfPlayTest, PerfectPlayAlwaysDraws) {
+    SelfPlayConfig config;
+    config.games = 4;
+    config.gamesPerTask = 1;
+    config.xPolicy.type = PolicyType::PERFECT;
+    config.oPolicy.type = PolicyType::PERFECT;
+
+    const SelfPlayReport report = runSelfPlay(config);
+    EXPECT_EQ(report.draws, 4u);
+}
+
+TEST(SelfPlayTest, PerfectPlayNeverLosesToRandom) {
+    SelfPlayConfig config;
+    config.games = 20;
+    config.gamesPerTask = 5;
+    config.xPolicy.type = PolicyType::RANDOM;
+    config.oPolicy.type = PolicyType::PERFECT;
+
+    const SelfPlayReport report = runSelfPlay(config);
+    EXPECT_EQ(report.xWins, 0u);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    for (std::uint64_t i = 1; i <= 1000; ++i) {
+        histogram.record(i * 1000);
+    }
+    EXPECT_EQ(histogram.getCount(), 1000u);
+    EXPECT_EQ(histogram.getMax(), 1000000u);
+
+    // Buckets are 1/8 of an octave wide
+    const double p50 = static_cast<double>(histogram.percentile(50.0));
+    EXPECT_GE(p50, 500000.0);
+    EXPECT_LE(p50, 500000.0 * 1.13);
+    EXPECT_EQ(histogram.percentile(100.0), 1000000u);
+}
+
+} // namespace test
+} // namespace tictactoe
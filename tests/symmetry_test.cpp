@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "game/symmetry.h"
+#include "game/basic_game_engine.h"
+#include <set>
+
+namespace tictactoe {
+namespace test {
+
+namespace {
+
+// Every position reachable in play, including finished games
+void collectPositions(ClassicGameEngine& engine, std::set<std::pair<int, int>>& seen)
+{
+    const auto key = std::make_pair(static_cast<int>(engine.getPlayerMask(Player::X)),
+                                    static_cast<int>(engine.getPlayerMask(Player::O)));
+    if (!seen.insert(key).second) {
+        return;
+    }
+    auto moves = engine.getLegalMoves();
+    while (moves != 0) {
+        const int cell = popLowestCell(moves);
+        engine.makeMove(cell);
+        collectPositions(engine, seen);
+        engine.undoMove();
+    }
+}
+
+} // namespace
+
+TEST(SymmetryTest, CellMaps) {
+    using S = Symmetry<3>;
+    // 0 1 2
+    // 3 4 5
+    // 6 7 8
+    EXPECT_EQ(S::mapCell(Transform::ROTATE_90, 0), 2);
+    EXPECT_EQ(S::mapCell(Transform::ROTATE_180, 0), 8);
+    EXPECT_EQ(S::mapCell(Transform::ROTATE_270, 0), 6);
+    EXPECT_EQ(S::mapCell(Transform::MIRROR, 3), 5);
+    EXPECT_EQ(S::mapCell(Transform::FLIP, 1), 7);
+    EXPECT_EQ(S::mapCell(Transform::TRANSPOSE, 1), 3);
+    EXPECT_EQ(S::mapCell(Transform::ANTI_TRANSPOSE, 1), 5);
+    EXPECT_EQ(S::inverse(Transform::ROTATE_90), Transform::ROTATE_270);
+    EXPECT_EQ(S::inverse(Transform::TRANSPOSE), Transform::TRANSPOSE);
+
+    for (int t = 0; t < 8; ++t) {
+        const auto transform = static_cast<Transform>(t);
+        EXPECT_EQ(S::mapCell(transform, 4), 4);
+        for (int cell = 0; cell < 9; ++cell) {
+            EXPECT_EQ(S::unmapCell(transform, S::mapCell(transform, cell)), cell);
+        }
+    }
+}
+
+TEST(SymmetryTest, TransformsKeepWinLines) {
+    using Lines = WinLines<4, 4>;
+    for (int t = 0; t < 8; ++t) {
+        for (int line = 0; line < Lines::kCount; ++line) {
+            const auto image = Symmetry<4>::apply(static_cast<Transform>(t), Lines::kMasks[line]);
+            bool found = false;
+            for (int other = 0; other < Lines::kCount; ++other) {
+                found = found || Lines::kMasks[other] == image;
+            }
+            EXPECT_TRUE(found);
+        }
+    }
+}
+
+TEST(SymmetryTest, ClassicPositionClasses) {
+    ClassicGameEngine engine;
+    std::set<std::pair<int, int>> positions;
+    collectPositions(engine, positions);
+    EXPECT_EQ(positions.size(), 5478u);
+
+    std::set<std::uint64_t> classes;
+    for (const auto& position : positions) {
+        const auto x = static_cast<std::uint16_t>(position.first);
+        const auto o = static_cast<std::uint16_t>(position.second);
+        const auto canonical = Symmetry<3>::canonicalize(x, o);
+        EXPECT_EQ(canonical.xMask, Symmetry<3>::apply(canonical.transform, x));
+        EXPECT_EQ(canonical.oMask, Symmetry<3>::apply(canonical.transform, o));
+
+        // Every image of a position has the same representative
+        for (int t = 0; t < 8; ++t) {
+            const auto transform = static_cast<Transform>(t);
+            const auto image = Symmetry<3>::canonicalize(Symmetry<3>::apply(transform, x),
+                                                         Symmetry<3>::apply(transform, o));
+            EXPECT_EQ(image.xMask, canonical.xMask);
+            EXPECT_EQ(image.oMask, canonical.oMask);
+        }
+        classes.insert(Symmetry<3>::canonicalIndex(x, o));
+    }
+    EXPECT_EQ(classes.size(), 765u);
+}
+
+TEST(SymmetryTest, MapMoveBackFromCanonical) {
+    ClassicGameEngine engine;
+    engine.makeMove(0, 2); // X in the top-right corner
+    const auto canonical = Symmetry<3>::canonicalize(engine.getPlayerMask(Player::X),
+                                                     engine.getPlayerMask(Player::O));
+    // A reply chosen on the canonical board lands on the same cell relative
+    // to the real X stone
+    const int xCell = lowestCell(canonical.xMask);
+    const int replyCell = Symmetry<3>::mapCell(Transform::ROTATE_180, xCell);
+    EXPECT_EQ(Symmetry<3>::unmapCell(canonical.transform, replyCell), 6);
+}
+
+TEST(SymmetryTest, GomokuWideMasks) {
+    using S = Symmetry<15>;
+    S::Mask x = maskOf<S::Mask>(0) | maskOf<S::Mask>(16);
+    S::Mask o = maskOf<S::Mask>(210); // bottom-left corner
+    const auto canonical = S::canonicalize(x, o);
+    for (int t = 0; t < 8; ++t) {
+        const auto transform = static_cast<Transform>(t);
+        const auto image = S::canonicalize(S::apply(transform, x), S::apply(transform, o));
+        EXPECT_TRUE(image.xMask == canonical.xMask);
+        EXPECT_TRUE(image.oMask == canonical.oMask);
+    }
+    EXPECT_EQ(cellCount(S::apply(Transform::ROTATE_90, x)), 2);
+    EXPECT_TRUE(hasCell(S::apply(Transform::ROTATE_90, o), 0));
+}
+
+} // namespace test
+} // namespace tictactoe
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include "game/tablebase.h"
+#include "game/retrograde_solver.h"
+#include "game/ai_opponent.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace tictactoe {
+namespace test {
+
+namespace {
+
+std::string tempPath(const char* name)
+{
+    return std::string(::testing::TempDir()) + name;
+}
+
+std::vector<char> readFile(const std::string& path)
+{
+    std::vector<char> bytes;
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return bytes;
+    }
+    char buffer[4096];
+    std::size_t count = 0;
+    while ((count = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    }
+    std::fclose(file);
+    return bytes;
+}
+
+void writeFile(const std::string& path, const std::vector<char>& bytes)
+{
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+    std::fclose(file);
+}
+
+// 100 entries of 4 bits: 7 words
+TablebaseInfo sampleInfo()
+{
+    TablebaseInfo info;
+    info.cells = 9;
+    info.winLength = 3;
+    info.dimensions = 2;
+    info.bitsPerEntry = 4;
+    info.entries = 100;
+    return info;
+}
+
+std::vector<std::uint64_t> sampleWords()
+{
+    std::vector<std::uint64_t> words(7);
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        words[i] = 0x0123456789ABCDEFull * (i + 1);
+    }
+    return words;
+}
+
+} // namespace
+
+TEST(TablebaseTest, WriteAndOpen) {
+    const std::string path = tempPath("sample.tablebase");
+    const auto words = sampleWords();
+    ASSERT_TRUE(Tablebase::write(path, sampleInfo(), words.data(), words.size()));
+
+    Tablebase base;
+    EXPECT_FALSE(base.isOpen());
+    ASSERT_TRUE(base.open(path, Tablebase::Verify::FULL)) << Tablebase::describeError(base.getError());
+    EXPECT_TRUE(base.isOpen());
+#if defined(__unix__) || defined(__APPLE__) || defined(_WIN32)
+    EXPECT_TRUE(base.isMapped());
+#endif
+    EXPECT_EQ(base.getInfo().cells, 9u);
+    EXPECT_EQ(base.getInfo().bitsPerEntry, 4u);
+    EXPECT_EQ(base.getInfo().entries, 100u);
+    ASSERT_EQ(base.getWordCount(), words.size());
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        EXPECT_EQ(base.getWords()[i], words[i]);
+    }
+    EXPECT_TRUE(base.verify());
+
+    base.close();
+    EXPECT_FALSE(base.isOpen());
+    EXPECT_EQ(base.getWords(), nullptr);
+    std::remove(path.c_str());
+}
+
+TEST(TablebaseTest, WriteRejectsWrongPayloadSize) {
+    const auto words = sampleWords();
+    EXPECT_FALSE(Tablebase::write(tempPath("short.tablebase"), sampleInfo(), words.data(), words.size() - 1));
+}
+
+TEST(TablebaseTest, DetectsDamage) {
+    const std::string path = tempPath("damaged.tablebase");
+    const auto words = sampleWords();
+    ASSERT_TRUE(Tablebase::write(path, sampleInfo(), words.data(), words.size()));
+    const std::vector<char> good = readFile(path);
+    ASSERT_EQ(good.size(), Tablebase::kHeaderBytes + words.size() * 8);
+
+    Tablebase base;
+    auto openDamaged = [&](std::vector<char> bytes, Tablebase::Verify verify) {
+        writeFile(path, bytes);
+        return base.open(path, verify);
+    };
+
+    // A flipped payload bit passes the header check but not verify()
+    std::vector<char> bytes = good;
+    bytes[Tablebase::kHeaderBytes + 13] ^= 0x10;
+    ASSERT_TRUE(openDamaged(bytes, Tablebase::Verify::HEADER));
+    EXPECT_FALSE(base.verify());
+    EXPECT_FALSE(openDamaged(bytes, Tablebase::Verify::FULL));
+    EXPECT_EQ(base.getError(), TablebaseError::BAD_CHECKSUM);
+    EXPECT_FALSE(base.isOpen());
+
+    bytes = good;
+    bytes[16] ^= 0x01;   // cell count
+    EXPECT_FALSE(openDamaged(bytes, Tablebase::Verify::HEADER));
+    EXPECT_EQ(base.getError(), TablebaseError::BAD_HEADER);
+
+    bytes = good;
+    bytes[0] = 'X';
+    EXPECT_FALSE(openDamaged(bytes, Tablebase::Verify::HEADER));
+    EXPECT_EQ(base.getError(), TablebaseError::BAD_MAGIC);
+
+    bytes = good;
+    bytes.pop_back();
+    EXPECT_FALSE(openDamaged(bytes, Tablebase::Verify::HEADER));
+    EXPECT_EQ(base.getError(), TablebaseError::SIZE_MISMATCH);
+
+    bytes = good;
+    bytes.push_back(0);
+    EXPECT_FALSE(openDamaged(bytes, Tablebase::Verify::HEADER));
+    EXPECT_EQ(base.getError(), TablebaseError::SIZE_MISMATCH);
+
+    EXPECT_FALSE(openDamaged(std::vector<char>(), Tablebase::Verify::HEADER));
+    EXPECT_EQ(base.getError(), TablebaseError::SIZE_MISMATCH);
+
+    // Byte-swapped mark, as a host of the other byte order would write it
+    bytes = good;
+    std::swap(bytes[12], bytes[15]);
+    std::swap(bytes[13], bytes[14]);
+    EXPECT_FALSE(openDamaged(bytes, Tablebase::Verify::HEADER));
+    EXPECT_EQ(base.getError(), TablebaseError::WRONG_BYTE_ORDER);
+
+    std::remove(path.c_str());
+    EXPECT_FALSE(base.open(path));
+    EXPECT_EQ(base.getError(), TablebaseError::OPEN_FAILED);
+
+    // A good open clears the error
+    writeFile(path, good);
+    EXPECT_TRUE(base.open(path));
+    EXPECT_EQ(base.getError(), TablebaseError::NONE);
+    std::remove(path.c_str());
+}
+
+TEST(TablebaseTest, OutcomeTableMapsFile) {
+    const auto solved = RetrogradeSolver<ClassicGameEngine>::solve(1);
+    const std::string path = tempPath("classic.tablebase");
+    ASSERT_TRUE(solved.save(path));
+
+    OutcomeTable<ClassicGameEngine> mapped;
+    ASSERT_TRUE(mapped.load(path, Tablebase::Verify::FULL));
+#if defined(__unix__) || defined(__APPLE__) || defined(_WIN32)
+    EXPECT_TRUE(mapped.isMapped());
+#endif
+    EXPECT_FALSE(solved.isMapped());
+    for (std::uint64_t index = 0; index < OutcomeTable<ClassicGameEngine>::kPositions; ++index) {
+        ASSERT_EQ(mapped.get(index), solved.get(index));
+    }
+
+    // Copies share the mapping
+    const OutcomeTable<ClassicGameEngine> copy = mapped;
+    EXPECT_EQ(copy.get(0), Outcome::DRAW);
+
+    // A file for another board is refused by the table and by the AI
+    OutcomeTable<GameEngine4x4> other;
+    EXPECT_FALSE(other.load(path));
+    BasicAIOpponent<GameEngine4x4> ai4x4;
+    EXPECT_FALSE(ai4x4.openTablebase(path));
+    BasicAIOpponent<GomokuEngine> gomoku;
+    EXPECT_FALSE(gomoku.openTablebase(path));
+    AIOpponent classic;
+    EXPECT_TRUE(classic.openTablebase(path));
+    std::remove(path.c_str());
+}
+
+} // namespace test
+} // namespace tictactoe
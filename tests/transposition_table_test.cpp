@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "game/transposition_table.h"
+#include "game/ai_opponent.h"
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace tictactoe {
+namespace test {
+
+TEST(TranspositionTableTest, StoreAndProbe) {
+    TranspositionTable table(64);
+    EXPECT_EQ(table.getCapacity(), 64u);
+
+    TTEntry entry;
+    EXPECT_FALSE(table.probe(42, entry));
+
+    table.store(42, -17, 5, 3, Bound::LOWER);
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_EQ(entry.score, -17);
+    EXPECT_EQ(entry.move, 5);
+    EXPECT_EQ(entry.depth, 3);
+    EXPECT_EQ(entry.bound, Bound::LOWER);
+
+    // Same key overwrites in place
+    table.store(42, 8, 1, 2, Bound::EXACT);
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_EQ(entry.score, 8);
+    EXPECT_EQ(table.getUsage(), 1u);
+
+    table.clear();
+    EXPECT_FALSE(table.probe(42, entry));
+}
+
+TEST(TranspositionTableTest, CapacityRoundsUpToBuckets) {
+    TranspositionTable table(10);
+    EXPECT_EQ(table.getCapacity(), 16u);
+    table.resize(1000);
+    EXPECT_EQ(table.getCapacity(), 1024u);
+}
+
+TEST(TranspositionTableTest, DepthPreferredKeepsDeepEntries) {
+    // A single bucket: every key collides
+    TranspositionTable table(4, TranspositionTable::Replacement::DEPTH_PREFERRED);
+    for (std::uint64_t key = 1; key <= 4; ++key) {
+        table.store(key, 0, 0, 9, Bound::EXACT);
+    }
+    table.store(5, 0, 0, 1, Bound::EXACT);
+    TTEntry entry;
+    EXPECT_FALSE(table.probe(5, entry));
+
+    // Entries from an earlier search give way
+    table.newSearch();
+    table.store(5, 0, 0, 1, Bound::EXACT);
+    EXPECT_TRUE(table.probe(5, entry));
+
+    table.setReplacement(TranspositionTable::Replacement::ALWAYS);
+    table.store(6, 0, 0, 1, Bound::EXACT);
+    EXPECT_TRUE(table.probe(6, entry));
+    EXPECT_EQ(table.getUsage(), 4u);
+}
+
+TEST(TranspositionTableTest, AIMovesMatchAcrossCalls) {
+    // A warm table must not change any answer: compare against a fresh AI
+    // over random 4x4 games, searched from the eighth stone on (the 3x3 AI
+    // answers from its solution table instead of searching)
+    BasicAIOpponent<GameEngine4x4> warm;
+    std::mt19937_64 rng(7);
+    for (int game = 0; game < 10; ++game) {
+        GameEngine4x4 engine;
+        while (!engine.isGameOver()) {
+            if (engine.getMoveCount() >= 7) {
+                BasicAIOpponent<GameEngine4x4> fresh;
+                const auto expected = fresh.calculateBestMove(engine.getBoard(), engine.getCurrentPlayer());
+                const auto move = warm.calculateBestMove(engine.getBoard(), engine.getCurrentPlayer());
+                EXPECT_EQ(move, expected);
+            }
+
+            auto legal = engine.getLegalMoves();
+            for (std::uint64_t skip = rng() % cellCount(legal); skip > 0; --skip) {
+                popLowestCell(legal);
+            }
+            engine.makeMove(lowestCell(legal));
+        }
+    }
+    EXPECT_GT(warm.getTranspositionTable().getUsage(), 0u);
+}
+
+TEST(TranspositionTableTest, FourByFourOpeningSearch) {
+    // Exhaustive 4x4 search from two stones in is only practical because
+    // transpositions are merged
+    GameEngine4x4 engine;
+    engine.makeMove(0, 0);
+    engine.makeMove(3, 3);
+    engine.makeMove(1, 1);
+    engine.makeMove(2, 2);
+    BasicAIOpponent<GameEngine4x4> ai(std::size_t(1) << 20);
+    const auto move = ai.calculateBestMove(engine.getBoard(), engine.getCurrentPlayer());
+    EXPECT_TRUE(engine.isValidMove(move.first, move.second));
+}
+
+TEST(TranspositionTableTest, ConcurrentWritersNeverTearEntries) {
+    // Every writer stores fields derived from the key, so any entry a probe
+    // returns must be consistent with the key it was found under
+    TranspositionTable table(256);
+    std::vector<std::thread> threads;
+    std::atomic<int> torn(0);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&table, &torn, t] {
+            std::mt19937_64 rng(static_cast<std::uint64_t>(t));
+            for (int i = 0; i < 200000; ++i) {
+                const std::uint64_t key = rng() | 1;
+                const int score = static_cast<int>(key >> 48) & 0x3FFF;
+                table.store(key, score, static_cast<int>(key >> 40) & 0xFF, 1, Bound::EXACT);
+
+                TTEntry entry;
+                const std::uint64_t other = rng() | 1;
+                table.store(other, static_cast<int>(other >> 48) & 0x3FFF, static_cast<int>(other >> 40) & 0xFF, 1, Bound::EXACT);
+                if (table.probe(key, entry) &&
+                    (entry.score != score || entry.move != (static_cast<int>(key >> 40) & 0xFF))) {
+                    ++torn;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(torn.load(), 0);
+}
+
+} // namespace test
+} // namespace tictactoe
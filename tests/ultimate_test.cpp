@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+#include "game/ultimate_game_engine.h"
+#include "game/ultimate_ai_opponent.h"
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace tictactoe {
+namespace test {
+
+namespace {
+
+std::uint64_t perft(UltimateGameEngine& engine, int depth)
+{
+    if (depth == 0 || engine.isGameOver()) {
+        return depth == 0 ? 1 : 0;
+    }
+    auto moves = engine.getLegalMoves();
+    if (depth == 1) {
+        return static_cast<std::uint64_t>(cellCount(moves));
+    }
+    std::uint64_t leaves = 0;
+    while (!isEmptyMask(moves)) {
+        const int cell = popLowestCell(moves);
+        engine.makeMove(cell);
+        leaves += perft(engine, depth - 1);
+        engine.undoMove();
+    }
+    return leaves;
+}
+
+bool hasThreeInRow(const std::array<Player, 9>& squares, Player player)
+{
+    for (const auto& line : ClassicGameEngine::Lines::kCells) {
+        if (squares[line[0]] == player && squares[line[1]] == player && squares[line[2]] == player) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The game state rescanned from the 9 x 9 grid
+GameState referenceState(const UltimateGameEngine& engine)
+{
+    const auto grid = engine.getBoard();
+    std::array<Player, 9> meta{};
+    bool allClosed = true;
+    for (int board = 0; board < 9; ++board) {
+        std::array<Player, 9> squares;
+        bool full = true;
+        for (int square = 0; square < 9; ++square) {
+            const int cell = UltimateGameEngine::cellOf(board, square);
+            squares[square] = grid[UltimateGameEngine::rowOf(cell)][UltimateGameEngine::colOf(cell)];
+            full = full && squares[square] != Player::NONE;
+        }
+        if (hasThreeInRow(squares, Player::X)) {
+            meta[board] = Player::X;
+        } else if (hasThreeInRow(squares, Player::O)) {
+            meta[board] = Player::O;
+        }
+        allClosed = allClosed && (full || meta[board] != Player::NONE);
+    }
+    if (hasThreeInRow(meta, Player::X)) {
+        return GameState::X_WON;
+    }
+    if (hasThreeInRow(meta, Player::O)) {
+        return GameState::O_WON;
+    }
+    return allClosed ? GameState::DRAW : GameState::IN_PROGRESS;
+}
+
+// Plays random moves until the side to move has a move that ends the game
+// in its favour; false if the game ended first
+bool playToWinningChance(UltimateGameEngine& engine, std::mt19937_64& rng, int& winningMove)
+{
+    while (!engine.isGameOver()) {
+        auto moves = engine.getLegalMoves();
+        std::vector<int> cells;
+        while (!isEmptyMask(moves)) {
+            cells.push_back(popLowestCell(moves));
+        }
+        for (const int cell : cells) {
+            engine.makeMove(cell);
+            const bool won = engine.getGameState() == GameState::X_WON || engine.getGameState() == GameState::O_WON;
+            engine.undoMove();
+            if (won) {
+                winningMove = cell;
+                return true;
+            }
+        }
+        engine.makeMove(cells[std::uniform_int_distribution<std::size_t>(0, cells.size() - 1)(rng)]);
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(UltimateGameEngineTest, CellMapping) {
+    for (int cell = 0; cell < UltimateGameEngine::kCells; ++cell) {
+        EXPECT_EQ(UltimateGameEngine::cellAt(UltimateGameEngine::rowOf(cell), UltimateGameEngine::colOf(cell)), cell);
+    }
+    // Centre square of the top-right sub-board
+    EXPECT_EQ(UltimateGameEngine::cellAt(1, 7), UltimateGameEngine::cellOf(2, 4));
+    EXPECT_EQ(UltimateGameEngine::cellAt(8, 0), UltimateGameEngine::cellOf(6, 6));
+}
+
+TEST(UltimateGameEngineTest, Perft) {
+    UltimateGameEngine engine;
+    EXPECT_EQ(perft(engine, 1), 81u);
+    EXPECT_EQ(perft(engine, 2), 720u);
+    EXPECT_EQ(perft(engine, 3), 6336u);
+    EXPECT_EQ(perft(engine, 4), 55080u);
+    EXPECT_EQ(perft(engine, 5), 473256u);
+}
+
+TEST(UltimateGameEngineTest, MoveSendsOpponentToSubBoard) {
+    UltimateGameEngine engine;
+    EXPECT_EQ(engine.getForcedBoard(), UltimateGameEngine::kAnyBoard);
+    EXPECT_EQ(engine.getPlayableBoards(), UltimateGameEngine::kFullSubBoard);
+
+    // X in the top-right square of the centre board sends O to the
+    // top-right board
+    ASSERT_TRUE(engine.makeMove(UltimateGameEngine::cellOf(4, 2)));
+    EXPECT_EQ(engine.getForcedBoard(), 2);
+    EXPECT_EQ(engine.getPlayableBoards(), 1u << 2);
+    EXPECT_FALSE(engine.makeMove(UltimateGameEngine::cellOf(4, 0)));
+    EXPECT_FALSE(engine.isValidMove(4, 3));
+    EXPECT_TRUE(engine.isValidMove(0, 6));
+    EXPECT_EQ(cellCount(engine.getLegalMoves()), 9);
+    EXPECT_EQ(engine.getCurrentPlayer(), Player::O);
+}
+
+TEST(UltimateGameEngineTest, ClosedSubBoardFreesTheChoice) {
+    // X wins the middle row of board 0 while O is sent back and forth
+    UltimateGameEngine engine;
+    for (const auto& move : {std::make_pair(0, 3), std::make_pair(3, 0), std::make_pair(0, 4),
+                             std::make_pair(4, 0), std::make_pair(0, 5)}) {
+        ASSERT_TRUE(engine.makeMove(UltimateGameEngine::cellOf(move.first, move.second)));
+    }
+    EXPECT_EQ(engine.getWonBoards(Player::X), 1u);
+    EXPECT_EQ(engine.getClosedBoards(), 1u);
+    EXPECT_EQ(engine.getForcedBoard(), 5);
+
+    // O is sent to the won board 0 and may play anywhere else
+    ASSERT_TRUE(engine.makeMove(UltimateGameEngine::cellOf(5, 0)));
+    EXPECT_EQ(engine.getForcedBoard(), UltimateGameEngine::kAnyBoard);
+    EXPECT_EQ(engine.getPlayableBoards(), UltimateGameEngine::kFullSubBoard & ~1u);
+    EXPECT_FALSE(engine.makeMove(UltimateGameEngine::cellOf(0, 0)));
+    EXPECT_EQ(cellCount(engine.getLegalMoves()), 72 - 3);
+    EXPECT_TRUE(engine.makeMove(UltimateGameEngine::cellOf(7, 7)));
+
+    // Undo reopens the board and restores the forced board
+    engine.undoMove();
+    engine.undoMove();
+    EXPECT_EQ(engine.getForcedBoard(), 5);
+    engine.undoMove();
+    EXPECT_EQ(engine.getWonBoards(Player::X), 0u);
+    EXPECT_EQ(engine.getClosedBoards(), 0u);
+    EXPECT_EQ(engine.getForcedBoard(), 0);
+}
+
+TEST(UltimateGameEngineTest, RandomGamesMatchFullScan) {
+    std::mt19937_64 rng(7);
+    for (int game = 0; game < 200; ++game) {
+        UltimateGameEngine engine;
+        std::vector<std::uint64_t> keys{engine.getZobristKey()};
+        while (!engine.isGameOver()) {
+            const auto legal = engine.getLegalMoves();
+            for (int cell = 0; cell < UltimateGameEngine::kCells; ++cell) {
+                ASSERT_EQ(hasCell(legal, cell),
+                          engine.isValidMove(UltimateGameEngine::rowOf(cell), UltimateGameEngine::colOf(cell)));
+            }
+            auto moves = legal;
+            std::vector<int> cells;
+            while (!isEmptyMask(moves)) {
+                cells.push_back(popLowestCell(moves));
+            }
+            ASSERT_FALSE(cells.empty());
+            ASSERT_TRUE(engine.makeMove(cells[std::uniform_int_distribution<std::size_t>(0, cells.size() - 1)(rng)]));
+            ASSERT_EQ(engine.getGameState(), referenceState(engine));
+            keys.push_back(engine.getZobristKey());
+        }
+        EXPECT_TRUE(isEmptyMask(engine.getLegalMoves()));
+
+        // Undo walks every key back
+        while (engine.getMoveCount() > 0) {
+            keys.pop_back();
+            ASSERT_TRUE(engine.undoMove());
+            ASSERT_EQ(engine.getZobristKey(), keys.back());
+            ASSERT_EQ(engine.getGameState(), GameState::IN_PROGRESS);
+        }
+        EXPECT_FALSE(engine.undoMove());
+        EXPECT_EQ(cellCount(engine.getLegalMoves()), 81);
+    }
+}
+
+TEST(UltimateAIOpponentTest, TakesWinningMove) {
+    std::mt19937_64 rng(3);
+    int found = 0;
+    for (int game = 0; game < 20 && found < 5; ++game) {
+        UltimateGameEngine engine;
+        int winningMove = -1;
+        if (!playToWinningChance(engine, rng, winningMove)) {
+            continue;
+        }
+        ++found;
+
+        UltimateAIOpponent ai;
+        SearchLimits limits;
+        limits.moveTime = std::chrono::milliseconds(200);
+        ai.setSearchLimits(limits);
+        const int move = ai.calculateBestMove(engine);
+        ASSERT_TRUE(engine.makeMove(move));
+        EXPECT_NE(engine.getGameState(), GameState::IN_PROGRESS);
+        EXPECT_NE(engine.getGameState(), GameState::DRAW);
+    }
+    EXPECT_GT(found, 0);
+}
+
+TEST(UltimateAIOpponentTest, RespectsLimitsAndReportsStats) {
+    UltimateGameEngine engine;
+    UltimateAIOpponent ai;
+    SearchLimits limits;
+    limits.moveTime = std::chrono::milliseconds(100);
+    ai.setSearchLimits(limits);
+
+    int reported = 0;
+    ai.setStatsCallback([&](const SearchStats&) { ++reported; });
+
+    // Self-play for a few moves: every answer is legal and in time
+    for (int ply = 0; ply < 6 && !engine.isGameOver(); ++ply) {
+        const auto start = std::chrono::steady_clock::now();
+        const int move = ai.calculateBestMove(engine);
+        EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+        ASSERT_TRUE(engine.makeMove(move));
+        const SearchStats stats = ai.getSearchStats();
+        EXPECT_GE(stats.completedDepth, 1);
+        EXPECT_GT(stats.nodes, 0u);
+    }
+    EXPECT_EQ(reported, 6);
+
+    // A node budget alone bounds the search too
+    limits = SearchLimits{};
+    limits.maxNodes = 2000;
+    ai.setSearchLimits(limits);
+    EXPECT_GE(ai.calculateBestMove(engine), 0);
+    EXPECT_LE(ai.getSearchStats().nodes, 2000u + 81u);
+}
+
+TEST(UltimateAIOpponentTest, EvaluationAndGameOver) {
+    UltimateGameEngine engine;
+    for (const auto& move : {std::make_pair(0, 3), std::make_pair(3, 0), std::make_pair(0, 4),
+                             std::make_pair(4, 0), std::make_pair(0, 5)}) {
+        engine.makeMove(UltimateGameEngine::cellOf(move.first, move.second));
+    }
+    UltimateAIOpponent ai;
+    EXPECT_GE(ai.calculateBestMove(engine), 0);
+    EXPECT_GT(UltimateAIOpponent::evaluatePosition(engine), -10000);
+    // O to move, a sub-board down
+    EXPECT_LT(UltimateAIOpponent::evaluatePosition(engine), 0);
+
+    UltimateGameEngine over;
+    std::mt19937_64 rng(11);
+    int winningMove = -1;
+    while (!playToWinningChance(over, rng, winningMove)) {
+        over.resetGame();
+    }
+    over.makeMove(winningMove);
+    EXPECT_EQ(ai.calculateBestMove(over), -1);
+    EXPECT_EQ(ai.getSearchStats().nodes, 0u);
+}
+
+} // namespace test
+} // namespace tictactoe
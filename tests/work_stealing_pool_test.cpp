@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "concurrency/work_stealing_pool.h"
+#include <atomic>
+
+namespace tictactoe {
+namespace test {
+
+TEST(WorkStealingPoolTest, RunsEveryTask) {
+    WorkStealingPool pool(4);
+    std::atomic<int> sum(0);
+    for (int i = 1; i <= 1000; ++i) {
+        pool.submit([&sum, i] { sum += i; });
+    }
+    pool.wait();
+    EXPECT_EQ(sum.load(), 500500);
+}
+
+TEST(WorkStealingPoolTest, TasksCanSpawnTasks) {
+    WorkStealingPool pool(3);
+    std::atomic<int> leaves(0);
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&pool, &leaves] {
+            EXPECT_GE(WorkStealingPool::currentWorkerIndex(), 0);
+            for (int j = 0; j < 10; ++j) {
+                pool.submit([&leaves] { ++leaves; });
+            }
+        });
+    }
+    pool.wait();
+    EXPECT_EQ(leaves.load(), 100);
+    EXPECT_EQ(WorkStealingPool::currentWorkerIndex(), -1);
+}
+
+TEST(WorkStealingPoolTest, ReusableAfterWait) {
+    WorkStealingPool pool(2);
+    std::atomic<int> count(0);
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < 20; ++i) {
+            pool.submit([&count] { ++count; });
+        }
+        pool.wait();
+        EXPECT_EQ(count.load(), 20 * (round + 1));
+    }
+}
+
+} // namespace test
+} // namespace tictactoe